@@ -1,6 +1,8 @@
 #include "Main.h" // Force to include this file first
 
 #include <libeng/Tools/Tools.h>
+#include "Video/CamFrame.h"
+#include "Video/PixelConvert.h"
 #ifdef LIBENG_ENABLE_SOCIAL
 #include <libeng/Social/Session.h>
 #endif
@@ -209,12 +211,8 @@ JNIEXPORT jshort Java_com_studio_artaban_bullettime_EngLibrary_loadTexture(JNIEn
             // Convert RGBA color buffer into LA buffer (Luminance Alpha)
             unsigned int graySize = width * height;
             jbyte* grayBuffer = new jbyte[graySize * 2];
-
-            for (unsigned int i = 0; i < graySize; ++i) {
-
-                grayBuffer[(i * 2) + 0] = buffer[(i * 4) + 0]; // Luminance (Red == Green == Blue: 0 -> Red)
-                grayBuffer[(i * 2) + 1] = buffer[(i * 4) + 3]; // Alpha
-            }
+            PixelConvert::toLA(reinterpret_cast<char*>(grayBuffer), reinterpret_cast<const char*>(buffer),
+                    static_cast<int>(graySize)); // Luminance (Red == Green == Blue: 0 -> Red) & Alpha
             delete []  buffer;
             buffer = grayBuffer;
         }
@@ -314,7 +312,9 @@ JNIEXPORT void Java_com_studio_artaban_bullettime_EngLibrary_loadCamera(JNIEnv*
     }
     assert(camBufferLen == len);
     env->GetByteArrayRegion(data, 0, len, camBuffer);
+    CamFrame::delivered(); // Capture time
     platformLoadCamera(reinterpret_cast<const unsigned char*>(camBuffer));
+    CamFrame::published(); // Frame arrival event
 }
 JNIEXPORT void Java_com_studio_artaban_bullettime_EngLibrary_loadMic(JNIEnv* env, jobject obj, jint len,
         jshortArray data) {
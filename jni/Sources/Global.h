@@ -26,6 +26,14 @@
 //#define PAID_VERSION // No advertising + No logo into video
 #define DEMO_VERSION // No advertising
 
+// Recording mode
+//#define CONTINUOUS_RECORD // Keep recording the last RECORD_DURATION_BEFORE seconds until GO is pressed (dashcam)
+//#define SPOOL_RECORD // Keep recorded frames into a single memory-mapped file (instead of RAM)
+//#define HIGH_FPS_RECORD 30 // Capture frame rate (24 or 30) if the device can sustain it (see 'Recorder::arm')
+//#define HD_RECORD // Capture & record 720p frames (instead of 640x480 - see 'CamFrame::setCamera')
+//#define COMPRESS_RECORD // Keep recorded frames compressed (JPEG) into RAM: Longer RECORD_DURATION_BEFORE
+//#define ENCODER_PROFILE 2 // Encoding profile: 0 fast preview, 1 balanced, 2 archival (chosen per take otherwise)
+
 
 #define DISPLAY_DELAY               100
 #define MAX_COLOR                   255.f
@@ -48,10 +56,14 @@
 #define FONT_HEIGHT                 46
 
 // Camera
-#define CAM_WIDTH                   640
+#define CAM_WIDTH                   640 // Default resolution & display ratio (see 'CamFrame')
 #define CAM_HEIGHT                  480
 #define CAM_TEX_WIDTH               1024.f
 #define CAM_TEX_HEIGHT              512.f
+#define CAM_HD_WIDTH                1280 // 720p resolution
+#define CAM_HD_HEIGHT               720
+#define CAM_HD_TEX_WIDTH            2048.f
+#define CAM_HD_TEX_HEIGHT           1024.f
 
 // Log levels (< 5 to log)
 #define LOG_LEVEL_BULLETTIME        4
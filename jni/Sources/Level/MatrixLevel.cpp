@@ -29,7 +29,7 @@
 
 //////
 MatrixLevel::MatrixLevel(Game* game) : Level(game), mLandscape(true), mFrameNo(0), mStatus(MCAM_NONE), mApp(game),
-        mMovRecording(false), mRecCounter(0), mRecBound(0.f), mGO(false), mMicRecording(REC_MIC_NONE) {
+        mMovRecording(false), mRecCounter(0), mRecBound(0), mGO(false), mMicRecording(REC_MIC_NONE) {
 
     LOGV(LOG_LEVEL_MATRIXLEVEL, 0, LOG_FORMAT(" - g:%x"), __PRETTY_FUNCTION__, __LINE__, game);
     std::memset(&mServerArea, 0, sizeof(TouchArea));
@@ -122,8 +122,13 @@ bool MatrixLevel::loaded(const Game* game) {
                 mHideCam->resume(0, 0, 0);
 
             // Camera
-            if (!mCamera->isStarted())
-                mCamera->start(CAM_WIDTH, CAM_HEIGHT);
+            if (!mCamera->isStarted()) {
+
+#ifdef HD_RECORD
+                CamFrame::setCamera(CamFrame::RES_HD); // Session resolution (sent to the clients)
+#endif
+                mCamera->start(CamFrame::getWidth(true), CamFrame::getHeight(true));
+            }
             break;
         }
         case 2: {
@@ -138,6 +143,9 @@ bool MatrixLevel::loaded(const Game* game) {
 
                 mVideo = new Video();
                 mVideo->initialize(game2DVia(game));
+#ifdef ENCODER_PROFILE
+                mVideo->setProfile(ENCODER_PROFILE); // See 'EncoderProfile::choose' otherwise
+#endif
                 Picture::removePath(mVideo->getPicFolder());
 
                 mRecMicFile.assign(*mVideo->getPicFolder());
@@ -162,6 +170,13 @@ bool MatrixLevel::loaded(const Game* game) {
 #else
             mTextures->genTexture(2);
 #endif
+#ifdef HIGH_FPS_RECORD
+#ifndef PAID_VERSION
+            mVideo->getRecorder()->arm(HIGH_FPS_RECORD, mFontBuffer); // Self-benchmark (default frame rate if refused)
+#else
+            mVideo->getRecorder()->arm(HIGH_FPS_RECORD); // Self-benchmark (default frame rate if refused)
+#endif
+#endif
 
 #if !defined(PAID_VERSION) && !defined(DEMO_VERSION)
             // Advertising
@@ -211,8 +226,8 @@ bool MatrixLevel::loaded(const Game* game) {
 #ifndef __ANDROID__
                 mFilm->setBGRA(true);
 #endif
-                static const float texCoord[8] = { 0.f, 0.f, 0.f, CAM_HEIGHT / CAM_TEX_HEIGHT, CAM_WIDTH / CAM_TEX_WIDTH,
-                        CAM_HEIGHT / CAM_TEX_HEIGHT, CAM_WIDTH / CAM_TEX_WIDTH, 0.f };
+                float texCoord[8];
+                CamFrame::getTexCoords(texCoord, true);
                 mFilm->setTexCoords(texCoord);
 
                 short screenW = (game->getScreen()->width >> 1) * SCREEN_SCALE_RATIO; // Half
@@ -246,20 +261,22 @@ bool MatrixLevel::loaded(const Game* game) {
 #endif
                 mBackCam->setAlpha(0.f);
 
-                short backW = CAM_WIDTH;
-                short backH = (CAM_WIDTH * game->getScreen()->height) / game->getScreen()->width;
-                if (backH > CAM_HEIGHT) {
-                    backH = CAM_HEIGHT;
-                    backW = (CAM_HEIGHT * game->getScreen()->width) / game->getScreen()->height;
+                short camW = CamFrame::getWidth(true);
+                short camH = CamFrame::getHeight(true);
+                short backW = camW;
+                short backH = (camW * game->getScreen()->height) / game->getScreen()->width;
+                if (backH > camH) {
+                    backH = camH;
+                    backW = (camH * game->getScreen()->width) / game->getScreen()->height;
                 }
                 mBackCam->setVertices(0, 0, game->getScreen()->width, game->getScreen()->height);
 
                 float texCoord[8];
-                texCoord[0] = ((CAM_WIDTH >> 1) - (backW >> 1)) / CAM_TEX_WIDTH;
-                texCoord[1] = ((CAM_HEIGHT >> 1) + (backH >> 1)) / CAM_TEX_HEIGHT;
+                texCoord[0] = ((camW >> 1) - (backW >> 1)) / CamFrame::getTexWidth(true);
+                texCoord[1] = ((camH >> 1) + (backH >> 1)) / CamFrame::getTexHeight(true);
                 texCoord[2] = texCoord[0];
-                texCoord[3] = ((CAM_HEIGHT >> 1) - (backH >> 1)) / CAM_TEX_HEIGHT;
-                texCoord[4] = ((CAM_WIDTH >> 1) + (backW >> 1)) / CAM_TEX_WIDTH;
+                texCoord[3] = ((camH >> 1) - (backH >> 1)) / CamFrame::getTexHeight(true);
+                texCoord[4] = ((camW >> 1) + (backW >> 1)) / CamFrame::getTexWidth(true);
                 texCoord[5] = texCoord[3];
                 texCoord[6] = texCoord[4];
                 texCoord[7] = texCoord[1];
@@ -775,28 +792,40 @@ bool MatrixLevel::update(const Game* game) {
                 if (!mMovRecording)
                     break;
 
-                clock_t now = clock();
-                if (((now - mRecCounter) / game->mTickPerSecond) > mRecBound) {
+                unsigned int now = CamFrame::now();
+                if ((now - mRecCounter) > mRecBound) {
 
                     mRecCounter = now;
-                    mRecBound = 1.f / MAX_VIDEO_FPS;
-                    time_t elapsed = mVideo->getRecorder()->add(mCamera->getCamBuffer(), true);
-                    if ((!elapsed) || ((elapsed - mRecElapsed) > RECORD_DURATION_BEFORE) || (mGO)) {
+                    mRecBound = 1000 / mVideo->getRecorder()->getRate();
+                    unsigned int elapsed = mVideo->getRecorder()->add(mCamera->getCamBuffer(), true, CamFrame::getStamp());
+                    bool continuous = mVideo->getRecorder()->isContinuous(); // Wait GO (dashcam)
+                    if ((!elapsed) || ((!continuous) && ((elapsed - mRecElapsed) > (RECORD_DURATION_BEFORE * 1000))) ||
+                            (mGO)) {
 
                         ////// Go!
                         mConnexion->go();
+#ifndef PAID_VERSION
+                        mVideo->getRecorder()->start(mFontBuffer, mLandscape); // Convert while recording after GO
+#else
+                        mVideo->getRecorder()->start(mLandscape); // Convert while recording after GO
+#endif
 
-                        mRecBound = 0.f;
-                        mRecCounter = clock();
-                        mRecElapsed = time(NULL);
+                        mRecBound = 0;
+                        mRecCounter = CamFrame::now();
+                        mRecElapsed = mRecCounter;
                         mCount->setCount(game2DVia(game), mFilm->getBottom(), RECORD_DURATION_AFTER, mLandscape);
                         if (mStatus == MCAM_GO) // Means still client(s) available (can be MCAM_WAIT for all client in pause/lockscreen)
                             mStatus = MCAM_DOWNLOAD;
                     }
                     else {
 
-                        mCount->setCount(game2DVia(game), mFilm->getBottom(),
-                                RECORD_DURATION_BEFORE - (elapsed - mRecElapsed), mLandscape);
+                        elapsed = (elapsed > mRecElapsed)? (elapsed - mRecElapsed) / 1000:0; // In seconds
+                        if (continuous) // Buffered duration
+                            mCount->setCount(game2DVia(game), mFilm->getBottom(),
+                                    (elapsed < RECORD_DURATION_BEFORE)? elapsed:RECORD_DURATION_BEFORE, mLandscape);
+                        else
+                            mCount->setCount(game2DVia(game), mFilm->getBottom(),
+                                    (elapsed < RECORD_DURATION_BEFORE)? RECORD_DURATION_BEFORE - elapsed:0, mLandscape);
 
                         if (mMicRecording == REC_MIC_STOPPED) {
 #ifdef __ANDROID__
@@ -896,31 +925,31 @@ bool MatrixLevel::update(const Game* game) {
 
                 if ((1 == mFrameNo) && (mMovRecording)) { // Server (only)
 
-                    clock_t now = clock();
-                    if (((now - mRecCounter) / game->mTickPerSecond) > mRecBound) {
+                    unsigned int now = CamFrame::now();
+                    if ((now - mRecCounter) > mRecBound) {
 
                         mRecCounter = now;
-                        mRecBound = 1.f / MAX_VIDEO_FPS;
-                        time_t elapsed = mVideo->getRecorder()->add(mCamera->getCamBuffer(), false);
-                        if ((!elapsed) || ((elapsed - mRecElapsed) > RECORD_DURATION_AFTER)) {
+                        mRecBound = 1000 / mVideo->getRecorder()->getRate();
+                        unsigned int elapsed = mVideo->getRecorder()->add(mCamera->getCamBuffer(), false,
+                                CamFrame::getStamp());
+                        if ((!elapsed) || ((elapsed - mRecElapsed) > (RECORD_DURATION_AFTER * 1000))) {
 
                             if (mMicRecording == REC_MIC_STARTED)
                                 Mic::stopRecorder();
                             mMicRecording = REC_MIC_NONE;
-#ifndef PAID_VERSION
-                            mVideo->getRecorder()->start(mFontBuffer, mLandscape);
-#ifndef DEMO_VERSION
+                            mVideo->getRecorder()->stop();
+#if !defined(PAID_VERSION) && !defined(DEMO_VERSION)
                             mAdvertising->display(0);
-#endif
-#else
-                            mVideo->getRecorder()->start(mLandscape);
 #endif
                             mMovRecording = false;
                             done(); // Finished
                         }
-                        else
+                        else {
+
+                            elapsed = (elapsed > mRecElapsed)? (elapsed - mRecElapsed) / 1000:0; // In seconds
                             mCount->setCount(game2DVia(game), mFilm->getBottom(),
-                                    RECORD_DURATION_AFTER - (elapsed - mRecElapsed), mLandscape);
+                                    (elapsed < RECORD_DURATION_AFTER)? RECORD_DURATION_AFTER - elapsed:0, mLandscape);
+                        }
                     }
                 }
             }
@@ -1025,11 +1054,29 @@ bool MatrixLevel::update(const Game* game) {
 #else
                     Mic::initRecorder(mRecMicFile, kAudioFormatMPEG4AAC, 44100.f, 1);
 #endif
-                    mRecBound = 0.f;
-                    mRecCounter = clock();
-                    mCount->setCount(game2DVia(game), mFilm->getBottom(), RECORD_DURATION_BEFORE, mLandscape);
-                    mRecElapsed = time(NULL);
+                    mRecBound = 0;
+                    mRecCounter = CamFrame::now();
+                    mRecElapsed = mRecCounter;
                     mVideo->getRecorder()->clear();
+#ifdef CONTINUOUS_RECORD
+                    mVideo->getRecorder()->setContinuous(true);
+#endif
+#ifdef SPOOL_RECORD
+                    mVideo->getRecorder()->setSpool(true);
+#endif
+#ifdef COMPRESS_RECORD
+                    mVideo->getRecorder()->setCompress(true);
+#endif
+                    mVideo->getRecorder()->reserve(); // Frames kept in RAM (no file I/O while recording)
+                    mVideo->getRecorder()->prepare(mLandscape); // Pre-warm encoder sessions while waiting GO
+                    if (mVideo->getRecorder()->isCompress()) // Compress frames while recording
+#ifndef PAID_VERSION
+                        mVideo->getRecorder()->start(mFontBuffer, mLandscape);
+#else
+                        mVideo->getRecorder()->start(mLandscape);
+#endif
+                    mCount->setCount(game2DVia(game), mFilm->getBottom(),
+                            (mVideo->getRecorder()->isContinuous())? 0:RECORD_DURATION_BEFORE, mLandscape);
                     break;
                 }
                 case Connexion::CONN_DOWNLOAD: {
@@ -1092,6 +1139,7 @@ bool MatrixLevel::update(const Game* game) {
                         LOGI(LOG_LEVEL_MATRIXLEVEL, 0, LOG_FORMAT(" - Free space available: %f"), __PRETTY_FUNCTION__, __LINE__, space);
                     }
 #endif
+                    CamFrame::resetSession(); // Camera resolution (even if previously client of another session)
                     mConnexion = new Connexion(true, this);
                     mFrameNo = 1;
                     mFrame->show();
@@ -20,6 +20,7 @@
 #include "Wifi/SearchIP.h"
 #include "Wifi/Connexion.h"
 #include "Share/Share.h"
+#include "Video/CamFrame.h"
 
 #else
 #include "PanelCoords.h"
@@ -28,6 +29,7 @@
 #include "SearchIP.h"
 #include "Connexion.h"
 #include "Share.h"
+#include "CamFrame.h"
 
 #endif
 #include <time.h>
@@ -77,9 +79,9 @@ private:
     unsigned char mMicRecording;
     bool mMovRecording;
 
-    float mRecBound;
-    clock_t mRecCounter;
-    time_t mRecElapsed;
+    unsigned int mRecBound; // In milliseconds (monotonic time - see 'CamFrame')
+    unsigned int mRecCounter; // ...
+    unsigned int mRecElapsed; // ...
 
 public:
     enum {
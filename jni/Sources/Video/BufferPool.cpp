@@ -0,0 +1,144 @@
+#include "BufferPool.h"
+
+#include <new>
+
+BufferPool::SizeClass BufferPool::mClasses[POOL_CLASS_COUNT];
+boost::mutex BufferPool::mMutex;
+
+size_t BufferPool::mWarmSize = 0;
+size_t BufferPool::mUsedSize = 0;
+size_t BufferPool::mHighWater = 0;
+
+//////
+char* BufferPool::get(size_t size) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%u"), __PRETTY_FUNCTION__, __LINE__, static_cast<unsigned int>(size));
+    unsigned char sizeClass = 0;
+    while ((sizeClass < POOL_CLASS_COUNT) && (getClassSize(sizeClass) < size))
+        ++sizeClass;
+
+    char* buffer = NULL;
+    size_t classSize = size;
+    if (sizeClass != POOL_CLASS_COUNT) {
+
+        classSize = getClassSize(sizeClass);
+        mMutex.lock();
+        SizeClass* pool = &mClasses[sizeClass];
+        if (!pool->warm.empty()) {
+
+            buffer = pool->warm.back();
+            pool->warm.pop_back();
+            mWarmSize -= classSize;
+            ++pool->hits;
+        }
+        else
+            ++pool->misses;
+        ++pool->used;
+        mUsedSize += classSize;
+        if (mUsedSize > mHighWater)
+            mHighWater = mUsedSize;
+        mMutex.unlock();
+    }
+    else
+        sizeClass = POOL_NO_CLASS;
+
+    if (!buffer) {
+
+        try { buffer = new char[classSize + POOL_HEADER]; }
+        catch (const std::bad_alloc &e) {
+
+            LOGW(LOG_FORMAT(" - Failed to allocate %u bytes"), __PRETTY_FUNCTION__, __LINE__,
+                    static_cast<unsigned int>(classSize));
+            if (sizeClass != POOL_NO_CLASS) {
+
+                mMutex.lock();
+                --mClasses[sizeClass].used;
+                mUsedSize -= classSize;
+                mMutex.unlock();
+            }
+            throw;
+        }
+        *buffer = static_cast<char>(sizeClass);
+    }
+    return buffer + POOL_HEADER;
+}
+void BufferPool::release(char* buffer) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - b:%x"), __PRETTY_FUNCTION__, __LINE__, buffer);
+    if (!buffer)
+        return;
+
+    buffer -= POOL_HEADER;
+    unsigned char sizeClass = static_cast<unsigned char>(*buffer);
+    if (sizeClass == POOL_NO_CLASS) {
+
+        delete [] buffer;
+        return;
+    }
+    assert(sizeClass < POOL_CLASS_COUNT);
+    size_t classSize = getClassSize(sizeClass);
+
+    mMutex.lock();
+    SizeClass* pool = &mClasses[sizeClass];
+    assert(pool->used > 0);
+    --pool->used;
+    mUsedSize -= classSize;
+    if ((pool->warm.size() < POOL_MAX_WARM) && ((mWarmSize + classSize) <= POOL_MAX_MEMORY)) {
+
+        pool->warm.push_back(buffer); // Keep it warm
+        mWarmSize += classSize;
+        buffer = NULL;
+    }
+    mMutex.unlock();
+
+    if (buffer)
+        delete [] buffer;
+}
+
+void BufferPool::trim() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (w:%u)"), __PRETTY_FUNCTION__, __LINE__,
+            static_cast<unsigned int>(mWarmSize));
+    mMutex.lock();
+    for (unsigned char i = 0; i < POOL_CLASS_COUNT; ++i) {
+        for (std::vector<char*>::iterator iter = mClasses[i].warm.begin(); iter != mClasses[i].warm.end(); ++iter)
+            delete [] (*iter);
+
+        mClasses[i].warm.clear();
+    }
+    mWarmSize = 0;
+    mMutex.unlock();
+}
+
+unsigned int BufferPool::getHits() {
+
+    unsigned int hits = 0;
+    mMutex.lock();
+    for (unsigned char i = 0; i < POOL_CLASS_COUNT; ++i)
+        hits += mClasses[i].hits;
+    mMutex.unlock();
+    return hits;
+}
+unsigned int BufferPool::getMisses() {
+
+    unsigned int misses = 0;
+    mMutex.lock();
+    for (unsigned char i = 0; i < POOL_CLASS_COUNT; ++i)
+        misses += mClasses[i].misses;
+    mMutex.unlock();
+    return misses;
+}
+void BufferPool::log() {
+
+    mMutex.lock();
+    for (unsigned char i = 0; i < POOL_CLASS_COUNT; ++i) {
+        if ((mClasses[i].hits) || (mClasses[i].misses))
+            LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Class %u bytes: h:%u; m:%u; u:%d; w:%d"), __PRETTY_FUNCTION__,
+                    __LINE__, static_cast<unsigned int>(getClassSize(i)), mClasses[i].hits, mClasses[i].misses,
+                    mClasses[i].used, static_cast<short>(mClasses[i].warm.size()));
+    }
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Used: %u bytes; Warm: %u bytes; High-water: %u bytes"), __PRETTY_FUNCTION__,
+            __LINE__, static_cast<unsigned int>(mUsedSize), static_cast<unsigned int>(mWarmSize),
+            static_cast<unsigned int>(mHighWater));
+    mMutex.unlock();
+}
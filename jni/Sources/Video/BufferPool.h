@@ -0,0 +1,54 @@
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <boost/thread.hpp>
+#include <vector>
+
+#define POOL_MIN_SIZE               4096 // Smallest size class (in byte)
+#define POOL_CLASS_COUNT            56 // 4 classes per power of 2 from 4 KB to 56 MB (less than 25% unused)
+#define POOL_NO_CLASS               0xff // Larger buffer (never kept)
+#define POOL_HEADER                 16 // Size class stored before each buffer (alignment kept)
+
+#define POOL_MAX_WARM               4 // Warm buffers kept per size class
+#define POOL_MAX_MEMORY             (32 * 1024 * 1024) // Warm buffers total size (in byte)
+
+//////
+class BufferPool { // Size-classed pool of frame, texture & scratch buffers (thread safe)
+
+private:
+    typedef struct {
+
+        std::vector<char*> warm;
+        unsigned int hits;
+        unsigned int misses;
+        short used; // Buffer count in use
+
+    } SizeClass;
+    static SizeClass mClasses[POOL_CLASS_COUNT];
+    static boost::mutex mMutex;
+
+    static size_t mWarmSize; // In byte
+    static size_t mUsedSize; // ...
+    static size_t mHighWater; // Max 'mUsedSize'
+
+    static inline size_t getClassSize(unsigned char sizeClass) {
+        return (static_cast<size_t>(POOL_MIN_SIZE) << (sizeClass >> 2)) * (4 + (sizeClass & 0x03)) / 4;
+    };
+
+public:
+    static char* get(size_t size); // Throw 'std::bad_alloc' as 'new' if failed
+    static void release(char* buffer); // Buffer returned by 'get' (or NULL)
+
+    static void trim(); // Free all warm buffers
+
+    static unsigned int getHits();
+    static unsigned int getMisses();
+    static inline size_t getHighWater() { return mHighWater; }
+    static void log(); // Statistics per size class
+
+};
+
+#endif // BUFFERPOOL_H_
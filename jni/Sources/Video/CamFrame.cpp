@@ -0,0 +1,89 @@
+#include "CamFrame.h"
+
+#include <stdint.h>
+
+#ifdef __ANDROID__
+#include <time.h>
+#else
+#include <mach/mach_time.h>
+#endif
+
+volatile unsigned int CamFrame::mStamp = 0;
+volatile unsigned int CamFrame::mSequence = 0;
+
+boost::mutex CamFrame::mMutex;
+boost::condition_variable CamFrame::mArrived;
+
+unsigned char CamFrame::mCamera = CamFrame::RES_VGA;
+unsigned char CamFrame::mSession = CamFrame::RES_VGA;
+
+//////
+unsigned int CamFrame::now() {
+
+    // Computed in 64 bits (32 bits 'long' overflows after ~24.8 days of uptime) & relative to the first call in order
+    // to keep 32 bits stamps increasing during the application life
+#ifdef __ANDROID__
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time); // Not affected by system time changes (!= 'time(NULL)')
+    int64_t millis = (static_cast<int64_t>(time.tv_sec) * 1000) + (time.tv_nsec / 1000000);
+#else
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+    if (!timebase.denom)
+        mach_timebase_info(&timebase);
+    int64_t millis = static_cast<int64_t>((mach_absolute_time() * timebase.numer / timebase.denom) / 1000000);
+#endif
+    static int64_t base = millis - 1; // 0 is reserved (see 'mStamp')
+    return static_cast<unsigned int>(millis - base);
+}
+void CamFrame::delivered() {
+
+    mStamp = now();
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%u"), __PRETTY_FUNCTION__, __LINE__, mStamp);
+}
+void CamFrame::published() {
+
+    mMutex.lock();
+    if (!++mSequence)
+        mSequence = 1; // 0 is reserved (see 'mSequence')
+    mMutex.unlock();
+    mArrived.notify_all();
+}
+unsigned int CamFrame::wait(unsigned int sequence, unsigned int timeout) {
+
+    boost::system_time until = boost::get_system_time() + boost::posix_time::milliseconds(timeout);
+    boost::mutex::scoped_lock lock(mMutex);
+    while (mSequence == sequence) {
+        if (!mArrived.timed_wait(lock, until))
+            break; // Timeout
+    }
+    return mSequence;
+}
+
+void CamFrame::crop(float* coords, short width, short height, float texWidth, float texHeight) {
+
+    short cropW = (height * CAM_WIDTH) / CAM_HEIGHT;
+    short cropH = height;
+    if (cropW > width) {
+
+        cropW = width;
+        cropH = (width * CAM_HEIGHT) / CAM_WIDTH;
+    }
+    coords[0] = ((width - cropW) >> 1) / texWidth;
+    coords[1] = ((height - cropH) >> 1) / texHeight;
+    coords[2] = coords[0];
+    coords[3] = ((height + cropH) >> 1) / texHeight;
+    coords[4] = ((width + cropW) >> 1) / texWidth;
+    coords[5] = coords[3];
+    coords[6] = coords[4];
+    coords[7] = coords[1];
+}
+void CamFrame::getTexCoords(float* coords, bool camera) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - c:%x; c:%s"), __PRETTY_FUNCTION__, __LINE__, coords, (camera)? "true":"false");
+    crop(coords, getWidth(camera), getHeight(camera), getTexWidth(camera), getTexHeight(camera));
+}
+void CamFrame::getPreviewTexCoords(float* coords) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - c:%x (s:%d)"), __PRETTY_FUNCTION__, __LINE__, coords, getPreviewScale());
+    crop(coords, getPreviewWidth(), getPreviewHeight(), CAM_TEX_WIDTH, CAM_TEX_HEIGHT);
+}
@@ -0,0 +1,80 @@
+#ifndef CAMFRAME_H_
+#define CAMFRAME_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <boost/thread.hpp>
+
+//////
+class CamFrame { // Camera frame delivery time & resolution
+
+public:
+    enum {
+
+        RES_VGA = 0, // CAM_WIDTH x CAM_HEIGHT
+        RES_HD, // CAM_HD_WIDTH x CAM_HD_HEIGHT
+
+        RES_COUNT
+    };
+
+private:
+    static void crop(float* coords, short width, short height, float texWidth, float texHeight);
+
+    static volatile unsigned int mStamp; // Delivery time of the current camera buffer (0: Unknown)
+    static volatile unsigned int mSequence; // Sequence number of the current camera buffer (0: None published)
+
+    static boost::mutex mMutex;
+    static boost::condition_variable mArrived; // Signaled when a new frame has been published
+
+    static unsigned char mCamera; // Camera resolution
+    static unsigned char mSession; // Session resolution (recorded & exchanged frames)
+
+public:
+    static inline void setCamera(unsigned char res) { mCamera = res; mSession = res; } // B4 starting camera
+    static inline void setSession(unsigned char res) { mSession = res; } // Client: Server resolution (see 'Connexion')
+    static inline void resetSession() { mSession = mCamera; } // Server: Camera resolution (& when disconnected)
+    static inline unsigned char getSession() { return mSession; }
+
+    // Session resolution (or camera resolution if 'camera' is true)
+    static inline short getWidth(bool camera = false) {
+        return ((((camera)? mCamera:mSession) == RES_HD)? CAM_HD_WIDTH:CAM_WIDTH);
+    };
+    static inline short getHeight(bool camera = false) {
+        return ((((camera)? mCamera:mSession) == RES_HD)? CAM_HD_HEIGHT:CAM_HEIGHT);
+    };
+    static inline float getTexWidth(bool camera = false) {
+        return ((((camera)? mCamera:mSession) == RES_HD)? CAM_HD_TEX_WIDTH:CAM_TEX_WIDTH);
+    };
+    static inline float getTexHeight(bool camera = false) {
+        return ((((camera)? mCamera:mSession) == RES_HD)? CAM_HD_TEX_HEIGHT:CAM_TEX_HEIGHT);
+    };
+    static inline int getSize(unsigned char pixel) { return getWidth() * getHeight() * pixel; } // Session frame (in byte)
+
+    static void getTexCoords(float* coords, bool camera = false); // Centered crop with CAM_WIDTH x CAM_HEIGHT display ratio
+
+    // Preview resolution: Recorded frames displayed into a CAM_TEX_WIDTH x CAM_TEX_HEIGHT texture (see 'Picture::extract')
+    static inline unsigned char getPreviewScale() { return (mSession == RES_HD)? 2:1; } // JPEG scaled IDCT: 1/1 or 1/2
+    static inline short getPreviewWidth() { return getWidth() / getPreviewScale(); }
+    static inline short getPreviewHeight() { return getHeight() / getPreviewScale(); }
+    static void getPreviewTexCoords(float* coords);
+
+    static unsigned int now(); // Monotonic time (in milliseconds)
+
+    static void delivered(); // Called by the camera thread when a new frame has been copied into the camera buffer
+    static inline unsigned int getStamp() { // Return the capture time of the current camera buffer
+
+        unsigned int stamp = mStamp;
+        return (stamp)? stamp:now(); // Delivery not stamped: Frame is captured now
+    };
+
+    static void published(); // Called by the camera thread once the new frame is available (see 'Camera::isBuffered')
+    static inline unsigned int getSequence() { return mSequence; }
+
+    static unsigned int wait(unsigned int sequence, unsigned int timeout);
+    // -> Block until a frame newer than 'sequence' is published or 'timeout' elapsed (in milliseconds) then return the
+    //    current sequence number (unchanged if timed out)
+
+};
+
+#endif // CAMFRAME_H_
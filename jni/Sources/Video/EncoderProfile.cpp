@@ -0,0 +1,126 @@
+#include "EncoderProfile.h"
+
+#ifdef __ANDROID__
+#include "Video/CamFrame.h"
+#else
+#include "CamFrame.h"
+#endif
+#include <libeng/Tools/Tools.h>
+
+using namespace eng;
+
+const EncoderProfile::Preset EncoderProfile::mPresets[PROFILE_COUNT] = {
+
+    { "fast-preview", 1, 8, 3, "ultrafast", 2, 0.5f },
+    { "balanced", 33333, 4, 2, "veryfast", 5, 1.f },
+    { "archival", 0, 0, 0, "medium", 10, 4.f }
+};
+float EncoderProfile::mFPS[PROFILE_COUNT][PROFILE_RES_COUNT] = { { 0.f, 0.f }, { 0.f, 0.f }, { 0.f, 0.f } };
+boost::mutex EncoderProfile::mMutex;
+
+//////
+unsigned char EncoderProfile::getThreads() {
+
+    unsigned char count = static_cast<unsigned char>(boost::thread::hardware_concurrency());
+    if (!count)
+        return 1; // Unknown core count
+
+    return (count > PROFILE_MAX_THREADS)? PROFILE_MAX_THREADS:count;
+}
+
+std::string EncoderProfile::getVP8(unsigned char profile, unsigned char fps) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - p:%d; f:%d"), __PRETTY_FUNCTION__, __LINE__, profile, fps);
+    assert(profile < PROFILE_COUNT);
+
+    std::string element("vp8enc threads=");
+    element.append(numToStr<short>(getThreads()));
+    element.append(" deadline=");
+    element.append(numToStr<int>(mPresets[profile].deadline));
+    element.append(" cpu-used=");
+    element.append(numToStr<short>(mPresets[profile].cpuUsed));
+    element.append(" token-partitions=");
+    element.append(numToStr<short>(mPresets[profile].tokenPartitions));
+    element.append(" keyframe-max-dist=");
+    element.append(numToStr<short>(static_cast<short>(mPresets[profile].keyFrame * fps)));
+    return element;
+}
+std::string EncoderProfile::getX264(unsigned char profile, unsigned char fps) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - p:%d; f:%d"), __PRETTY_FUNCTION__, __LINE__, profile, fps);
+    assert(profile < PROFILE_COUNT);
+
+    std::string element("x264enc threads=");
+    element.append(numToStr<short>(getThreads()));
+    element.append(" speed-preset=");
+    element.append(mPresets[profile].speedPreset);
+    element.append(" key-int-max=");
+    element.append(numToStr<short>(static_cast<short>(mPresets[profile].keyFrame * fps)));
+    return element;
+}
+
+void EncoderProfile::measure(unsigned char profile, short frames, unsigned int duration, unsigned char streams) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - p:%d; f:%d; d:%u; s:%d"), __PRETTY_FUNCTION__, __LINE__, profile, frames,
+            duration, streams);
+    assert(profile < PROFILE_COUNT);
+    assert(streams);
+    if ((frames < 1) || (!duration))
+        return;
+
+    float fps = (frames * streams * 1000.f) / duration;
+    unsigned char res = CamFrame::getSession();
+    assert(res < PROFILE_RES_COUNT);
+    mMutex.lock();
+    mFPS[profile][res] = (mFPS[profile][res] > 0.f)? ((mFPS[profile][res] + fps) / 2.f):fps; // Smoothed over the takes
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Profile %s (res:%d): %.1f fps (%.1f fps measured)"), __PRETTY_FUNCTION__,
+            __LINE__, mPresets[profile].name, res, mFPS[profile][res], fps);
+    mMutex.unlock();
+}
+float EncoderProfile::getFPS(unsigned char profile) {
+
+    assert(profile < PROFILE_COUNT);
+    assert(CamFrame::getSession() < PROFILE_RES_COUNT);
+    mMutex.lock();
+    float fps = mFPS[profile][CamFrame::getSession()];
+    mMutex.unlock();
+    return fps;
+}
+float EncoderProfile::estimate(unsigned char profile) {
+
+    assert(profile < PROFILE_COUNT);
+    unsigned char res = CamFrame::getSession();
+    assert(res < PROFILE_RES_COUNT);
+    float fps = 0.f;
+    mMutex.lock();
+    if (mFPS[profile][res] > 0.f)
+        fps = mFPS[profile][res];
+    else { // Not measured: Scale the speed of the nearest measured profile by their relative cost
+
+        for (unsigned char gap = 1; (fps <= 0.f) && (gap < PROFILE_COUNT); ++gap) {
+
+            if ((profile >= gap) && (mFPS[profile - gap][res] > 0.f))
+                fps = mFPS[profile - gap][res] * mPresets[profile - gap].cost / mPresets[profile].cost;
+            else if (((profile + gap) < PROFILE_COUNT) && (mFPS[profile + gap][res] > 0.f))
+                fps = mFPS[profile + gap][res] * mPresets[profile + gap].cost / mPresets[profile].cost;
+        }
+    }
+    mMutex.unlock();
+    return fps;
+}
+
+unsigned char EncoderProfile::choose(short frames, unsigned char streams) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%d; s:%d"), __PRETTY_FUNCTION__, __LINE__, frames, streams);
+    assert(streams);
+    for (unsigned char profile = PROFILE_ARCHIVAL; profile > PROFILE_FAST_PREVIEW; --profile) {
+
+        float fps = estimate(profile); // Measured once chosen (estimation replaced)
+        if (fps <= 0.f)
+            return PROFILE_BALANCED; // None measured yet (default)
+
+        if (((frames * streams * 1000.f) / fps) <= PROFILE_ENCODE_BUDGET)
+            return profile;
+    }
+    return PROFILE_FAST_PREVIEW; // Too slow
+}
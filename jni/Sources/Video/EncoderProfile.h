@@ -0,0 +1,73 @@
+#ifndef ENCODERPROFILE_H_
+#define ENCODERPROFILE_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <boost/thread.hpp>
+#include <string>
+
+#define PROFILE_ENCODE_BUDGET       10000 // Encoding duration expected for a take (in milliseconds - see 'choose')
+#define PROFILE_MAX_THREADS         8 // Maximum encoder thread count (whatever the core count)
+#define PROFILE_RES_COUNT           2 // Session resolution count (CamFrame::RES_VGA & RES_HD)
+
+//////
+class EncoderProfile { // Named 'vp8enc' & 'x264enc' presets with their measured encoding speed (thread safe)
+
+public:
+    enum {
+
+        PROFILE_FAST_PREVIEW = 0, // Realtime
+        PROFILE_BALANCED,
+        PROFILE_ARCHIVAL, // Best quality
+
+        PROFILE_COUNT,
+        PROFILE_AUTO = 0xff // See 'choose'
+    };
+
+private:
+    typedef struct {
+
+        const char* name;
+
+        int deadline; // 'vp8enc' deadline per frame (in microseconds - 0: Best; 1: Realtime)
+        char cpuUsed; // 'vp8enc' speed [-16;16] (quality when 0)
+        unsigned char tokenPartitions; // 'vp8enc' partition count (log2 - decoded by as many threads)
+        const char* speedPreset; // 'x264enc' speed preset
+        unsigned char keyFrame; // Key frame interval (in seconds)
+
+        float cost; // Expected encoding time relative to the balanced profile (estimation when not measured)
+
+    } Preset;
+    static const Preset mPresets[PROFILE_COUNT];
+
+    static float mFPS[PROFILE_COUNT][PROFILE_RES_COUNT];
+    // -> Measured encoding speed per session resolution (in frame per second & per encoded stream - 0: Not measured)
+    static boost::mutex mMutex;
+
+    static unsigned char getThreads(); // Encoder thread count according the core count
+    static float estimate(unsigned char profile); // Measured speed or estimated from another measured profile
+
+public:
+    static inline const char* getName(unsigned char profile) {
+
+        assert(profile < PROFILE_COUNT);
+        return mPresets[profile].name;
+    };
+
+    static std::string getVP8(unsigned char profile, unsigned char fps); // 'vp8enc' element with its properties
+    static std::string getX264(unsigned char profile, unsigned char fps); // 'x264enc' element with its properties
+    // -> 'fps': Video frame rate (key frame interval)
+
+    static void measure(unsigned char profile, short frames, unsigned int duration, unsigned char streams = 1);
+    // -> Record the encoding speed of 'frames' encoded in 'duration' (in milliseconds) into 'streams' videos (teed
+    //    pipeline) at the current session resolution
+    static float getFPS(unsigned char profile); // At the current session resolution (0: Not measured yet)
+
+    static unsigned char choose(short frames, unsigned char streams = 1);
+    // -> Best quality profile expected to encode 'frames' into 'streams' videos in PROFILE_ENCODE_BUDGET (balanced if
+    //    none measured yet at the current session resolution)
+
+};
+
+#endif // ENCODERPROFILE_H_
@@ -0,0 +1,444 @@
+#include "FrameCodec.h"
+
+#ifdef __ANDROID__
+#include <new>
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include "Video/BufferPool.h"
+
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+#include <setjmp.h>
+#include <jpeglib.h>
+
+typedef struct {
+
+    struct jpeg_error_mgr mgr;
+    jmp_buf jump;
+
+} JpegError;
+static void jpegErrorExit(j_common_ptr info) { // Replace default 'exit' call
+
+    char msg[JMSG_LENGTH_MAX];
+    (*info->err->format_message)(info, msg);
+    LOGE(LOG_FORMAT(" - libjpeg error: %s"), __PRETTY_FUNCTION__, __LINE__, msg);
+    longjmp(reinterpret_cast<JpegError*>(info->err)->jump, 1);
+}
+#endif
+
+//////
+FrameCodec::FrameCodec() : mType(CODEC_NONE), mWidth(0), mHeight(0), mParam(0) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+    mPipeline = NULL;
+    mSrc = NULL;
+    mSink = NULL;
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+    mCompress = NULL;
+    mDecompress = NULL;
+    mError = NULL;
+
+    mBuffer = NULL;
+    mCapacity = 0;
+    mOut = NULL;
+    mOutSize = 0;
+#endif
+}
+FrameCodec::~FrameCodec() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
+    close();
+}
+
+bool FrameCodec::open(unsigned char type, short width, short height, unsigned char param) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - t:%d; w:%d; h:%d; p:%d (t:%d)"), __PRETTY_FUNCTION__, __LINE__, type, width,
+            height, param, mType);
+    assert((type == CODEC_ENCODE) || (type == CODEC_DECODE));
+    assert((width > 0) && (height > 0));
+
+    if (isOpened(type, width, height, param))
+        return true; // Already opened
+    close();
+
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+    std::string pipeline;
+#ifdef GST_JPEG_ENCODER
+    if (type == CODEC_ENCODE) {
+
+        pipeline.assign("appsrc name=frame caps=\"video/x-raw,format=RGB,width=");
+        pipeline.append(numToStr<short>(width));
+        pipeline.append(",height=");
+        pipeline.append(numToStr<short>(height));
+        pipeline.append(",framerate=0/1\" ! jpegenc quality=");
+        pipeline.append(numToStr<short>(static_cast<short>(param)));
+        pipeline.append(" ! appsink name=output sync=false");
+    }
+#endif
+#ifdef GST_JPEG_DECODER
+    if (type == CODEC_DECODE) {
+
+        pipeline.assign("appsrc name=frame caps=\"image/jpeg,framerate=0/1\" ! jpegdec ! videoconvert ! ");
+        if (param > 1)
+            pipeline.append("videoscale ! "); // No scaled IDCT
+        pipeline.append("video/x-raw,format=RGB,width=");
+        pipeline.append(numToStr<short>(width));
+        pipeline.append(",height=");
+        pipeline.append(numToStr<short>(height));
+        pipeline.append(" ! appsink name=output sync=false");
+    }
+#endif
+    if (!pipeline.empty()) {
+
+        GError* error = NULL;
+        mPipeline = gst_parse_launch(pipeline.c_str(), &error);
+        if (error) {
+
+            LOGE(LOG_FORMAT(" - gStreamer error: %s"), __PRETTY_FUNCTION__, __LINE__, error->message);
+            g_clear_error(&error);
+            if (mPipeline)
+                gst_object_unref(GST_OBJECT(mPipeline));
+            mPipeline = NULL;
+            assert(NULL);
+            return false;
+        }
+        mSrc = gst_bin_get_by_name(GST_BIN(mPipeline), "frame");
+        mSink = gst_bin_get_by_name(GST_BIN(mPipeline), "output");
+        assert((mSrc) && (mSink));
+
+        gst_element_set_state(mPipeline, GST_STATE_PLAYING); // Preroll once the first frame is pushed (no wait)
+    }
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+    JpegError* error;
+    try { error = new JpegError; }
+    catch (const std::bad_alloc &e) {
+
+        LOGW(LOG_FORMAT(" - Failed to allocate error manager"), __PRETTY_FUNCTION__, __LINE__);
+        return false;
+    }
+    mError = error;
+    jpeg_std_error(&error->mgr);
+    error->mgr.error_exit = jpegErrorExit;
+#ifndef GST_JPEG_ENCODER
+    if (type == CODEC_ENCODE) {
+
+        mCompress = new jpeg_compress_struct;
+        mCompress->err = &error->mgr;
+        jpeg_create_compress(mCompress);
+
+        // Parameters kept from frame to frame
+        mCompress->image_width = static_cast<JDIMENSION>(width);
+        mCompress->image_height = static_cast<JDIMENSION>(height);
+        mCompress->input_components = 3;
+        mCompress->in_color_space = JCS_RGB; // Packed by the record kernel (no conversion needed)
+        jpeg_set_defaults(mCompress);
+        jpeg_set_quality(mCompress, static_cast<int>(param), TRUE);
+
+        mCapacity = static_cast<unsigned long>(width * height * 3); // JPEG never larger than the raw RGB frame
+        mBuffer = static_cast<unsigned char*>(malloc(mCapacity)); // 'malloc': Can be reallocated by libjpeg
+        if (!mBuffer) {
+
+            LOGW(LOG_FORMAT(" - Failed to allocate %lu bytes"), __PRETTY_FUNCTION__, __LINE__, mCapacity);
+            mType = type;
+            close();
+            return false;
+        }
+    }
+#endif
+#ifndef GST_JPEG_DECODER
+    if (type == CODEC_DECODE) {
+
+        assert((param == 1) || (param == 2) || (param == 4) || (param == 8));
+        mDecompress = new jpeg_decompress_struct;
+        mDecompress->err = &error->mgr;
+        jpeg_create_decompress(mDecompress);
+    }
+#endif
+#endif
+    mType = type;
+    mWidth = width;
+    mHeight = height;
+    mParam = param;
+    return true;
+}
+void FrameCodec::close() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (t:%d)"), __PRETTY_FUNCTION__, __LINE__, mType);
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+    if (mPipeline) {
+
+        gst_app_src_end_of_stream(GST_APP_SRC(mSrc));
+        gst_element_set_state(mPipeline, GST_STATE_NULL);
+        gst_object_unref(mSrc);
+        gst_object_unref(mSink);
+        gst_object_unref(GST_OBJECT(mPipeline));
+
+        mPipeline = NULL;
+        mSrc = NULL;
+        mSink = NULL;
+    }
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+    if (mCompress) {
+
+        jpeg_destroy_compress(mCompress);
+        delete mCompress;
+        mCompress = NULL;
+    }
+    if (mDecompress) {
+
+        jpeg_destroy_decompress(mDecompress);
+        delete mDecompress;
+        mDecompress = NULL;
+    }
+    if (mError) {
+
+        delete static_cast<JpegError*>(mError);
+        mError = NULL;
+    }
+    if (mBuffer)
+        free(mBuffer);
+    mBuffer = NULL;
+    mCapacity = 0;
+#endif
+    mType = CODEC_NONE;
+    mWidth = 0;
+    mHeight = 0;
+    mParam = 0;
+}
+
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+bool FrameCodec::process(const char* data, size_t size, char** out, int* outSize) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - d:%x; s:%d; o:%x (t:%d)"), __PRETTY_FUNCTION__, __LINE__, data, size,
+            *out, mType);
+    assert(mPipeline);
+
+    GstBuffer* buffer = gst_buffer_new_allocate(NULL, size, NULL); // Copy: 'data' can be reused once returned
+    gst_buffer_fill(buffer, 0, data, size);
+    if (gst_app_src_push_buffer(GST_APP_SRC(mSrc), buffer) != GST_FLOW_OK) {
+
+        LOGE(LOG_FORMAT(" - Failed to push %d bytes"), __PRETTY_FUNCTION__, __LINE__, size);
+        return false;
+    }
+    GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(mSink)); // NULL if EOS or error
+    if (!sample) {
+
+        LOGE(LOG_FORMAT(" - No sample"), __PRETTY_FUNCTION__, __LINE__);
+        return false;
+    }
+    bool done = false;
+    GstMapInfo info;
+    GstBuffer* result = gst_sample_get_buffer(sample);
+    if ((result) && (gst_buffer_map(result, &info, GST_MAP_READ))) {
+
+        if (!(*out)) {
+
+            try { *out = BufferPool::get(info.size); }
+            catch (const std::bad_alloc &e) {
+                LOGW(LOG_FORMAT(" - Failed to allocate %d bytes"), __PRETTY_FUNCTION__, __LINE__, info.size);
+            }
+            if (*out)
+                *outSize = static_cast<int>(info.size);
+        }
+        if ((*out) && (static_cast<int>(info.size) <= *outSize)) {
+
+            std::memcpy(*out, info.data, info.size);
+            *outSize = static_cast<int>(info.size);
+            done = true;
+        }
+#ifdef DEBUG
+        else if (*out) {
+            LOGE(LOG_FORMAT(" - Unexpected %d bytes result (%d expected)"), __PRETTY_FUNCTION__, __LINE__, info.size,
+                    *outSize);
+        }
+#endif
+        gst_buffer_unmap(result, &info);
+    }
+    gst_sample_unref(sample);
+    return done;
+}
+#endif
+
+bool FrameCodec::encode(const char* rgb, const char* file, char** out, int* outSize) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - r:%x; f:%s; o:%x (w:%d; h:%d; q:%d)"), __PRETTY_FUNCTION__, __LINE__, rgb,
+            (file)? file:"null", out, mWidth, mHeight, mParam);
+    assert(mType == CODEC_ENCODE);
+    assert(rgb);
+    assert((file) || ((out) && (outSize)));
+
+#ifdef GST_JPEG_ENCODER
+    char* jpeg = NULL;
+    int jpegSize = 0;
+    if (!process(rgb, static_cast<size_t>(mWidth * mHeight * 3), &jpeg, &jpegSize))
+        return false;
+
+#else
+    JpegError* error = static_cast<JpegError*>(mError);
+    if (setjmp(error->jump)) { // Error
+
+        jpeg_abort_compress(mCompress); // Keep session (parameters) for the next frame
+        assert(NULL);
+        return false;
+    }
+    mOut = mBuffer;
+    mOutSize = mCapacity;
+    jpeg_mem_dest(mCompress, &mOut, &mOutSize);
+    jpeg_start_compress(mCompress, TRUE);
+
+    JSAMPROW scanline[1];
+    while (mCompress->next_scanline < mCompress->image_height) {
+
+        scanline[0] = reinterpret_cast<JSAMPROW>(const_cast<char*>(rgb + (mCompress->next_scanline * mWidth * 3)));
+        jpeg_write_scanlines(mCompress, scanline, 1);
+    }
+    jpeg_finish_compress(mCompress);
+    if (mOut != mBuffer) { // Reallocated by libjpeg
+
+        free(mBuffer);
+        mBuffer = mOut;
+        mCapacity = mOutSize;
+    }
+    const char* jpeg = reinterpret_cast<const char*>(mOut);
+    int jpegSize = static_cast<int>(mOutSize);
+#endif
+
+    bool done = true;
+    if (file) {
+
+        FILE* jpegFile = fopen(file, "wb");
+        if (!jpegFile) {
+
+            LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, file);
+            assert(NULL);
+            done = false;
+        }
+        else {
+
+            if (fwrite(jpeg, sizeof(char), jpegSize, jpegFile) != static_cast<size_t>(jpegSize)) {
+
+                LOGE(LOG_FORMAT(" - Failed to write %d bytes into file %s"), __PRETTY_FUNCTION__, __LINE__, jpegSize,
+                        file);
+                done = false;
+            }
+            fclose(jpegFile);
+        }
+#ifdef GST_JPEG_ENCODER
+        BufferPool::release(jpeg);
+#endif
+    }
+    else {
+
+#ifdef GST_JPEG_ENCODER
+        *out = jpeg; // Already a new buffer
+        *outSize = jpegSize;
+#else
+        *out = NULL;
+        *outSize = 0;
+        try { *out = BufferPool::get(static_cast<size_t>(jpegSize)); } // Released into the pool (see 'RecFrame::jpeg')
+        catch (const std::bad_alloc &e) {
+            LOGW(LOG_FORMAT(" - Failed to allocate %d bytes"), __PRETTY_FUNCTION__, __LINE__, jpegSize);
+        }
+        if (*out) {
+
+            std::memcpy(*out, jpeg, jpegSize);
+            *outSize = jpegSize;
+        }
+        else
+            done = false;
+#endif
+    }
+    return done;
+}
+bool FrameCodec::decode(const char* fileName, char* rgb) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%s; r:%x (w:%d; h:%d; s:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            fileName, rgb, mWidth, mHeight, mParam);
+    assert(mType == CODEC_DECODE);
+    assert(rgb);
+
+#ifdef GST_JPEG_DECODER
+    std::ifstream ifs(fileName, std::ifstream::binary);
+    if (!ifs.is_open()) {
+
+        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
+        assert(NULL);
+        return false;
+    }
+    std::filebuf* pbuf = ifs.rdbuf();
+    int size = static_cast<int>(pbuf->pubseekoff(0, ifs.end, ifs.in));
+    pbuf->pubseekpos(0, ifs.in);
+
+    char* jpeg;
+    try { jpeg = BufferPool::get(static_cast<size_t>(size)); }
+    catch (const std::bad_alloc &e) {
+
+        LOGW(LOG_FORMAT(" - Failed to allocate %d bytes"), __PRETTY_FUNCTION__, __LINE__, size);
+        ifs.close();
+        return false;
+    }
+    pbuf->sgetn(jpeg, size);
+    ifs.close();
+
+    int rgbSize = mWidth * mHeight * 3;
+    bool done = process(jpeg, static_cast<size_t>(size), &rgb, &rgbSize);
+    BufferPool::release(jpeg);
+    return ((done) && (rgbSize == (mWidth * mHeight * 3)));
+
+#else
+    FILE* jpegFile = fopen(fileName, "rb");
+    if (!jpegFile) {
+
+        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
+        assert(NULL);
+        return false;
+    }
+    JpegError* error = static_cast<JpegError*>(mError);
+    if (setjmp(error->jump)) { // Error
+
+        jpeg_abort_decompress(mDecompress); // Keep session for the next frame
+        fclose(jpegFile);
+        assert(NULL);
+        return false;
+    }
+    jpeg_stdio_src(mDecompress, jpegFile);
+    jpeg_read_header(mDecompress, TRUE);
+
+    mDecompress->out_color_space = JCS_RGB;
+    mDecompress->scale_num = 1;
+    mDecompress->scale_denom = mParam; // Scaled IDCT: Downscale while decoding
+    mDecompress->dct_method = JDCT_IFAST;
+    jpeg_start_decompress(mDecompress);
+    if ((mDecompress->output_width != static_cast<JDIMENSION>(mWidth)) ||
+            (mDecompress->output_height != static_cast<JDIMENSION>(mHeight))) {
+
+        LOGE(LOG_FORMAT(" - Unexpected %dx%d JPEG output (%dx%d expected)"), __PRETTY_FUNCTION__, __LINE__,
+                static_cast<int>(mDecompress->output_width), static_cast<int>(mDecompress->output_height), mWidth,
+                mHeight);
+        jpeg_abort_decompress(mDecompress);
+        fclose(jpegFile);
+        return false;
+    }
+    JSAMPROW scanline[1];
+    while (mDecompress->output_scanline < mDecompress->output_height) {
+
+        scanline[0] = reinterpret_cast<JSAMPROW>(rgb + (mDecompress->output_scanline * mWidth * 3));
+        jpeg_read_scanlines(mDecompress, scanline, 1);
+    }
+    jpeg_finish_decompress(mDecompress);
+    fclose(jpegFile);
+    return true;
+#endif
+}
+
+#endif // __ANDROID__
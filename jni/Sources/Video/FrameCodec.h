@@ -0,0 +1,80 @@
+#ifndef FRAMECODEC_H_
+#define FRAMECODEC_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <libeng/Tools/Tools.h>
+#include <string>
+
+using namespace eng;
+
+#ifdef __ANDROID__
+//#define GST_JPEG_ENCODER // Encode JPEG with a gStreamer session (instead of libjpeg): Compare encoding time
+//#define GST_JPEG_DECODER // Decode JPEG with a gStreamer session (instead of libjpeg)
+
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+typedef struct _GstElement GstElement;
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+struct jpeg_compress_struct;
+struct jpeg_decompress_struct;
+#endif
+
+//////
+class FrameCodec { // JPEG codec session: Opened once per take then reused for each frame (one thread at a time)
+
+public:
+    enum {
+
+        CODEC_NONE = 0,
+        CODEC_ENCODE, // RGB -> JPEG
+        CODEC_DECODE // JPEG -> RGB
+    };
+
+private:
+    unsigned char mType;
+    short mWidth; // Raw frame resolution (RGB to encode or decoded)
+    short mHeight; // ...
+    unsigned char mParam; // Encoder: Quality [0;100]; Decoder: Downscale factor (1, 2, 4 or 8)
+
+#if defined(GST_JPEG_ENCODER) || defined(GST_JPEG_DECODER)
+    GstElement* mPipeline; // appsrc named 'frame' ! ... ! appsink named 'output'
+    GstElement* mSrc;
+    GstElement* mSink;
+
+    bool process(const char* data, size_t size, char** out, int* outSize);
+    // -> Push buffer & pull result into '*out' (new buffer if NULL, or existing '*outSize' buffer)
+#endif
+#if !defined(GST_JPEG_ENCODER) || !defined(GST_JPEG_DECODER)
+    struct jpeg_compress_struct* mCompress;
+    struct jpeg_decompress_struct* mDecompress;
+    void* mError; // Error manager (with jump buffer)
+
+    unsigned char* mBuffer; // Encoder output (reused from frame to frame)
+    unsigned long mCapacity; // In byte
+    unsigned char* mOut; // Encoder output of the current frame (reallocated by libjpeg if 'mCapacity' is too short)
+    unsigned long mOutSize; // ...
+#endif
+
+public:
+    FrameCodec();
+    virtual ~FrameCodec();
+
+    bool open(unsigned char type, short width, short height, unsigned char param);
+    void close();
+
+    inline bool isOpened(unsigned char type, short width, short height, unsigned char param) const {
+        return ((mType == type) && (mWidth == width) && (mHeight == height) && (mParam == param));
+    };
+
+    //////
+    bool encode(const char* rgb, const char* file, char** out = NULL, int* outSize = NULL);
+    // -> Compress RGB buffer into JPEG 'file' (or into a new 'out' buffer if 'file' is NULL)
+    bool decode(const char* fileName, char* rgb);
+    // -> Uncompress JPEG file into 'rgb' buffer (downscaled with scaled IDCT if libjpeg)
+
+};
+
+#endif // __ANDROID__
+#endif // FRAMECODEC_H_
@@ -0,0 +1,69 @@
+#ifndef FRAMEPATH_H_
+#define FRAMEPATH_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <string>
+#include <stdio.h>
+#include <cstring>
+
+#define MCAM_SUB_FOLDER         "/MCAM"
+#define PIC_FILE_NAME           "/img_"
+
+#define FRAME_PATH_MAX          512 // In byte (folder + frame file name)
+
+//////
+class FramePath { // Frame file path formatted into a fixed buffer (no string allocation per frame)
+
+private:
+    char mPath[FRAME_PATH_MAX];
+    size_t mPrefix; // '<folder>/MCAM/<name>' length
+
+public:
+    FramePath() : mPrefix(0) { mPath[0] = '\0'; }
+    FramePath(const std::string* folder, const char* name = PIC_FILE_NAME) { setFolder(folder, name); }
+    virtual ~FramePath() { }
+
+    inline void setFolder(const std::string* folder, const char* name = PIC_FILE_NAME) {
+
+        assert(folder);
+        assert(name);
+        size_t length = std::strlen(name);
+        assert((folder->size() + sizeof(MCAM_SUB_FOLDER) + length + 16) < FRAME_PATH_MAX);
+        mPrefix = folder->size();
+        std::memcpy(mPath, folder->c_str(), mPrefix);
+        std::memcpy(mPath + mPrefix, MCAM_SUB_FOLDER, sizeof(MCAM_SUB_FOLDER) - 1);
+        mPrefix += sizeof(MCAM_SUB_FOLDER) - 1;
+        std::memcpy(mPath + mPrefix, name, length + 1);
+        mPrefix += length;
+    };
+
+    // Return '<folder>/MCAM/img_<index><extension>' (valid until the next call)
+    inline const char* get(short index, const char* extension) {
+
+        assert(mPrefix);
+        snprintf(mPath + mPrefix, FRAME_PATH_MAX - mPrefix, "%d%s", index, extension);
+        return mPath;
+    };
+    // Return '<folder>/MCAM/img_<000><extension>' with a 3 digits client index (valid until the next call)
+    inline const char* getClient(unsigned char client, const char* extension) {
+
+        assert(mPrefix);
+        snprintf(mPath + mPrefix, FRAME_PATH_MAX - mPrefix, "%03d%s", client, extension);
+        return mPath;
+    };
+    // Return the client path if 'client' is not null, the recorded frame path otherwise (valid until the next call)
+    inline const char* getSource(short index, unsigned char client, const char* extension) {
+        return (client)? getClient(client, extension):get(index, extension);
+    };
+    // Return '<folder>/MCAM/<name>' prefix (for 'multifilesrc' pattern)
+    inline const char* getPrefix() {
+
+        mPath[mPrefix] = '\0';
+        return mPath;
+    };
+
+};
+
+#endif // FRAMEPATH_H_
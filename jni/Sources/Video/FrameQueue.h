@@ -0,0 +1,71 @@
+#ifndef FRAMEQUEUE_H_
+#define FRAMEQUEUE_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <vector>
+
+//////
+template<typename T>
+class FrameQueue { // Lock-free single producer/single consumer queue (fixed capacity)
+
+private:
+    std::vector<T> mItems;
+
+    volatile unsigned int mWrite; // Updated by the producer only
+    volatile unsigned int mRead; // Updated by the consumer only
+
+    unsigned int mMaxDepth; // Queue depth high-water mark (producer side)
+
+public:
+    FrameQueue() : mWrite(0), mRead(0), mMaxDepth(0) { }
+    virtual ~FrameQueue() { }
+
+    inline void resize(unsigned int capacity) { // WARNING: No producer or consumer should be running
+
+        mItems.resize(capacity);
+        reset();
+    };
+    inline void reset() { // ...
+
+        mWrite = 0;
+        mRead = 0;
+        mMaxDepth = 0;
+    };
+
+    inline unsigned int getCapacity() const { return static_cast<unsigned int>(mItems.size()); }
+    inline unsigned int getDepth() const { return mWrite - mRead; }
+    inline unsigned int getMaxDepth() const { return mMaxDepth; }
+
+    //////
+    inline bool push(const T &item) { // Producer (return false if full)
+
+        unsigned int write = mWrite;
+        if ((write - mRead) == static_cast<unsigned int>(mItems.size()))
+            return false;
+
+        mItems[write % mItems.size()] = item;
+        __sync_synchronize(); // Item written B4 being published
+        mWrite = write + 1;
+
+        if ((write + 1 - mRead) > mMaxDepth)
+            mMaxDepth = write + 1 - mRead;
+        return true;
+    };
+    inline bool pop(T &item) { // Consumer (return false if empty)
+
+        unsigned int read = mRead;
+        if (read == mWrite)
+            return false;
+
+        __sync_synchronize(); // Item read after being published
+        item = mItems[read % mItems.size()];
+        __sync_synchronize(); // Item read B4 its place is released
+        mRead = read + 1;
+        return true;
+    };
+
+};
+
+#endif // FRAMEQUEUE_H_
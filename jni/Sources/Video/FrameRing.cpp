@@ -0,0 +1,142 @@
+#include "FrameRing.h"
+
+#include <new>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//////
+FrameRing::FrameRing(size_t slotSize) : mSlotSize(slotSize), mSpool(-1), mMap(NULL), mMapSize(0) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%d"), __PRETTY_FUNCTION__, __LINE__, slotSize);
+}
+FrameRing::~FrameRing() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
+    free();
+}
+
+short FrameRing::allocate(short slots) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%d (c:%d)"), __PRETTY_FUNCTION__, __LINE__, slots,
+            static_cast<short>(mSlots.size()));
+    assert(slots > 0);
+    if (!mSlots.empty())
+        return static_cast<short>(mSlots.size()); // Already allocated
+
+    mSlots.reserve(slots);
+    for (short i = 0; i < slots; ++i) {
+
+        char* slot;
+        try { slot = new char[mSlotSize]; }
+        catch (const std::bad_alloc &e) {
+
+            LOGW(LOG_FORMAT(" - RAM is short: %d/%d slot(s) allocated"), __PRETTY_FUNCTION__, __LINE__,
+                    static_cast<short>(mSlots.size()), slots);
+            break;
+        }
+        mSlots.push_back(slot);
+    }
+    mFree.resize(static_cast<unsigned int>(mSlots.size()));
+    for (short i = 0; i < static_cast<short>(mSlots.size()); ++i)
+        mFree.push(i);
+
+    return static_cast<short>(mSlots.size());
+}
+short FrameRing::map(const std::string &file, short slots) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%s; s:%d (c:%d)"), __PRETTY_FUNCTION__, __LINE__, file.c_str(), slots,
+            static_cast<short>(mSlots.size()));
+    assert(slots > 0);
+    assert((sizeof(SpoolHeader) + (slots * sizeof(short))) <= RING_SPOOL_HEADER);
+    if (!mSlots.empty())
+        return static_cast<short>(mSlots.size()); // Already allocated
+
+    mSpool = open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (mSpool == -1) {
+
+        LOGE(LOG_FORMAT(" - Failed to create spool file %s"), __PRETTY_FUNCTION__, __LINE__, file.c_str());
+        return 0;
+    }
+    mMapSize = RING_SPOOL_HEADER + (slots * RING_SPOOL_STRIDE(mSlotSize));
+    // Blocks reserved (not a sparse file): No SIGBUS when writing into the mapping if the disk is full
+    int error = posix_fallocate(mSpool, 0, static_cast<off_t>(mMapSize));
+    if (error) {
+
+        LOGE(LOG_FORMAT(" - Failed to reserve spool file %s (%d bytes; err:%d)"), __PRETTY_FUNCTION__, __LINE__,
+                file.c_str(), mMapSize, error);
+        mMapSize = 0;
+        ::close(mSpool);
+        mSpool = -1;
+        remove(file.c_str());
+        return 0;
+    }
+    void* addr = mmap(NULL, mMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, mSpool, 0);
+    if (addr == MAP_FAILED) {
+
+        LOGE(LOG_FORMAT(" - Failed to map spool file %s"), __PRETTY_FUNCTION__, __LINE__, file.c_str());
+        ::close(mSpool);
+        mSpool = -1;
+        remove(file.c_str());
+        return 0;
+    }
+    mMap = static_cast<char*>(addr);
+    mSpoolFile.assign(file);
+
+    SpoolHeader* header = reinterpret_cast<SpoolHeader*>(mMap);
+    header->magic = RING_SPOOL_MAGIC;
+    header->slots = slots;
+    header->slotSize = static_cast<unsigned int>(mSlotSize);
+
+    mSlots.reserve(slots);
+    for (short i = 0; i < slots; ++i) {
+
+        header->frames[i] = RING_NO_SLOT;
+        mSlots.push_back(mMap + RING_SPOOL_HEADER + (i * RING_SPOOL_STRIDE(mSlotSize)));
+    }
+    mFree.resize(static_cast<unsigned int>(slots));
+    for (short i = 0; i < slots; ++i)
+        mFree.push(i);
+
+    return slots;
+}
+void FrameRing::free() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (c:%d; s:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            static_cast<short>(mSlots.size()), mSpool);
+    if (mMap) { // Spool
+
+        munmap(mMap, mMapSize);
+        ::close(mSpool);
+        remove(mSpoolFile.c_str());
+
+        mMap = NULL;
+        mMapSize = 0;
+        mSpool = -1;
+    }
+    else
+        for (std::vector<char*>::iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+            delete [] (*iter);
+    mSlots.clear();
+    mFree.resize(0);
+}
+
+short FrameRing::acquire() {
+
+    short slot;
+    if (!mFree.pop(slot))
+        return RING_NO_SLOT; // Full
+
+    return slot;
+}
+void FrameRing::release(short slot) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%d"), __PRETTY_FUNCTION__, __LINE__, slot);
+    setFrame(slot, RING_NO_SLOT);
+    if (!mFree.push(slot)) {
+
+        LOGE(LOG_FORMAT(" - Slot %d released twice"), __PRETTY_FUNCTION__, __LINE__, slot);
+        assert(NULL);
+    }
+}
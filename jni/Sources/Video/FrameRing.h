@@ -0,0 +1,80 @@
+#ifndef FRAMERING_H_
+#define FRAMERING_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <string>
+#include <vector>
+
+#ifdef __ANDROID__
+#include "Video/FrameQueue.h"
+#else
+#include "FrameQueue.h"
+#endif
+
+#define RING_MAX_MEMORY             100000000 // 100 MB
+#define RING_NO_SLOT                (-1)
+
+#define RING_SPOOL_MAGIC            0x4d43414d // 'MCAM'
+#define RING_SPOOL_HEADER           4096 // Header size (in byte): Magic + Slot count + Slot size + Frame index per slot
+#define RING_SPOOL_STRIDE(size)     ((((size) + RING_SPOOL_HEADER - 1) / RING_SPOOL_HEADER) * RING_SPOOL_HEADER) // Page aligned
+
+//////
+class FrameRing { // Fixed-capacity ring of pre-allocated frame buffers (slots)
+
+private:
+    std::vector<char*> mSlots;
+    FrameQueue<short> mFree; // Free slot indexes
+
+    size_t mSlotSize; // In byte
+
+    // Spool (slots mapped into a single file instead of RAM)
+    typedef struct {
+
+        unsigned int magic;
+        short slots;
+        unsigned int slotSize;
+        short frames[1]; // Frame index per slot (RING_NO_SLOT: Free)
+
+    } SpoolHeader;
+    std::string mSpoolFile;
+    int mSpool; // File descriptor (-1: No spool)
+    char* mMap;
+    size_t mMapSize;
+
+public:
+    FrameRing(size_t slotSize);
+    virtual ~FrameRing();
+
+    short allocate(short slots); // Return the slot count allocated (less than requested if RAM is short)
+    short map(const std::string &file, short slots); // Return the slot count mapped into the spool file (0 if failed)
+    void free(); // ...and remove spool file (if any)
+
+    inline bool isSpool() const { return (mSpool != -1); }
+    inline void setFrame(short slot, short frame) { // Update spool header index (if any)
+
+        if (mMap)
+            reinterpret_cast<SpoolHeader*>(mMap)->frames[slot] = frame;
+    };
+
+    inline void setSlotSize(size_t slotSize) { // Frame resolution (B4 allocating or mapping)
+
+        assert(mSlots.empty());
+        mSlotSize = slotSize;
+    };
+    inline short getCapacity() const { return static_cast<short>(mSlots.size()); }
+    inline size_t getSlotSize() const { return mSlotSize; }
+    inline char* get(short slot) const {
+
+        assert((slot > RING_NO_SLOT) && (slot < static_cast<short>(mSlots.size())));
+        return mSlots[slot];
+    };
+
+    //////
+    short acquire(); // Return RING_NO_SLOT if no more free slot (single thread: Recorder::add)
+    void release(short slot); // WARNING: One thread at a time (lock-free)
+
+};
+
+#endif // FRAMERING_H_
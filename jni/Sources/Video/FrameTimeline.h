@@ -0,0 +1,90 @@
+#ifndef FRAMETIMELINE_H_
+#define FRAMETIMELINE_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <vector>
+
+#ifdef __ANDROID__
+#include "Video/FramePath.h"
+#else
+#include "FramePath.h"
+#endif
+
+//////
+class FrameTimeline { // Edit list of a take: Ordered source frames & display durations (no frame file renamed or copied)
+
+public:
+    typedef struct {
+
+        short frame; // Recorded frame index: 'img_<frame>.jpg' (ignored for a client frame)
+        unsigned char client; // Client rank: 'img_<000>.jpg' (0: Recorded frame)
+        bool repeat; // Same source as a previous entry (already extracted)
+        unsigned int stamp; // Capture time (0: Bullet time frame)
+        unsigned int duration; // Display duration (in milliseconds - see 'Video::timeline')
+
+    } Entry;
+
+private:
+    std::vector<Entry> mEntries;
+
+public:
+    FrameTimeline() { }
+    virtual ~FrameTimeline() { }
+
+    inline void clear() { mEntries.clear(); }
+    inline void reserve(short count) { mEntries.reserve(count); }
+
+    inline void add(short frame, unsigned int stamp) { // Recorded frame
+
+        Entry entry = { frame, 0, false, stamp, 0 };
+        mEntries.push_back(entry);
+    };
+    inline void addClient(unsigned char client) { // Bullet time frame
+
+        assert(client);
+        Entry entry = { 0, client, false, 0, 0 };
+        mEntries.push_back(entry);
+    };
+    inline void repeat(short index) { // Display the source of the 'index' entry again (not captured)
+
+        assert(index < static_cast<short>(mEntries.size()));
+        Entry entry = mEntries[index];
+        entry.repeat = true;
+        entry.stamp = 0;
+        mEntries.push_back(entry);
+    };
+
+    inline short getCount() const { return static_cast<short>(mEntries.size()); }
+    inline Entry* get(short index) { return &mEntries[index]; }
+    inline const Entry* get(short index) const { return &mEntries[index]; }
+    inline bool isSame(short index, short other) const { // Same source frame
+
+        return ((mEntries[index].client == mEntries[other].client) &&
+                ((mEntries[index].client) || (mEntries[index].frame == mEntries[other].frame)));
+    };
+    inline short getHeld(short index) const { // Consecutive entries displaying the same source from 'index' (>= 1)
+
+        short held = 1;
+        while (((index + held) < getCount()) && (isSame(index + held, index)))
+            ++held;
+        return held;
+    };
+    inline short getEncodedCount() const { // Frame count encoded (consecutive entries with the same source once)
+
+        short count = 0;
+        for (short i = 0; i < getCount(); i += getHeld(i))
+            ++count;
+
+        return count;
+    };
+
+    // Return the source file path of the 'index' entry (valid until the next 'path' call)
+    inline const char* getPath(FramePath* path, short index, const char* extension) const {
+        return path->getSource(mEntries[index].frame, mEntries[index].client, extension);
+    };
+
+};
+
+#endif // FRAMETIMELINE_H_
@@ -0,0 +1,120 @@
+#include "LogoOverlay.h"
+
+#ifndef PAID_VERSION
+#include <new>
+
+#ifdef __ANDROID__
+#include "Video/PixelConvert.h"
+#else
+#include "PixelConvert.h"
+#endif
+
+//////
+LogoOverlay::LogoOverlay() : mTexture(NULL), mWidth(0), mHeight(0), mPremul(NULL), mInverse(NULL) {
+
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
+}
+LogoOverlay::~LogoOverlay() {
+
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
+    if (mPremul)
+        delete [] mPremul;
+    if (mInverse)
+        delete [] mInverse;
+}
+
+bool LogoOverlay::prepare(const unsigned char* texture, short texWidth, short left, short top, short width,
+        short height) {
+
+    assert(texture);
+    mMutex.lock();
+    if ((texture == mTexture) && (width == mWidth) && (height == mHeight)) {
+
+        mMutex.unlock();
+        return true; // Already built
+    }
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - t:%x; w:%d; l:%d; t:%d; w:%d; h:%d"), __PRETTY_FUNCTION__, __LINE__,
+            texture, texWidth, left, top, width, height);
+    if ((width != mWidth) || (height != mHeight)) {
+
+        if (mPremul)
+            delete [] mPremul;
+        if (mInverse)
+            delete [] mInverse;
+        mPremul = NULL;
+        mInverse = NULL;
+        try {
+            mPremul = new unsigned char[width * height * 3];
+            mInverse = new unsigned char[width * height * 3];
+        }
+        catch (const std::bad_alloc &e) {
+
+            LOGE(LOG_FORMAT(" - Failed to allocate %dx%d overlay"), __PRETTY_FUNCTION__, __LINE__, width, height);
+            if (mPremul)
+                delete [] mPremul;
+            mPremul = NULL;
+            mTexture = NULL;
+            mWidth = 0;
+            mHeight = 0;
+            mMutex.unlock();
+            return false;
+        }
+    }
+    mSpans.clear();
+    for (short y = 0; y < height; ++y) {
+
+        const unsigned char* texel = texture + ((((top + y) * texWidth) + left) * 4);
+        Span span = { y, 0, 0 };
+        for (short x = 0; x < width; ++x, texel += 4) {
+
+            int i = ((y * width) + x) * 3;
+            unsigned short alpha = texel[3];
+            mPremul[i + 0] = static_cast<unsigned char>(((texel[0] * alpha) + 127) / 255);
+            mPremul[i + 1] = static_cast<unsigned char>(((texel[1] * alpha) + 127) / 255);
+            mPremul[i + 2] = static_cast<unsigned char>(((texel[2] * alpha) + 127) / 255);
+            mInverse[i + 0] = mInverse[i + 1] = mInverse[i + 2] = static_cast<unsigned char>(255 - alpha);
+
+            if (alpha) {
+                if (!span.count)
+                    span.x = x;
+                ++span.count;
+            }
+            else if (span.count) { // Skip transparent pixels
+
+                mSpans.push_back(span);
+                span.count = 0;
+            }
+        }
+        if (span.count)
+            mSpans.push_back(span);
+    }
+    mTexture = texture;
+    mWidth = width;
+    mHeight = height;
+    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - %d span(s) for %dx%d logo"), __PRETTY_FUNCTION__, __LINE__,
+            static_cast<int>(mSpans.size()), width, height);
+    mMutex.unlock();
+    return true;
+}
+
+void LogoOverlay::blend(char* rgb, short rgbWidth, short left, short top) {
+
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - r:%x; w:%d; l:%d; t:%d"), __PRETTY_FUNCTION__, __LINE__, rgb, rgbWidth,
+            left, top);
+    mMutex.lock();
+    if (!mTexture) {
+
+        LOGW(LOG_FORMAT(" - Overlay not prepared"), __PRETTY_FUNCTION__, __LINE__);
+        mMutex.unlock();
+        return;
+    }
+    for (std::vector<Span>::const_iterator iter = mSpans.begin(); iter != mSpans.end(); ++iter) {
+
+        int i = ((iter->y * mWidth) + iter->x) * 3;
+        PixelConvert::blend(rgb + ((((top + iter->y) * rgbWidth) + left + iter->x) * 3), mPremul + i, mInverse + i,
+                iter->count * 3);
+    }
+    mMutex.unlock();
+}
+
+#endif // !PAID_VERSION
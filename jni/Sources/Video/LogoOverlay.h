@@ -0,0 +1,51 @@
+#ifndef LOGOOVERLAY_H_
+#define LOGOOVERLAY_H_
+
+#include "Global.h"
+
+#ifndef PAID_VERSION
+#include <libeng/Log/Log.h>
+#include <boost/thread.hpp>
+#include <vector>
+
+//////
+class LogoOverlay { // Logo rectangle extracted from the font texture & premultiplied once (shared by all pictures)
+
+private:
+    typedef struct {
+
+        short y; // Logo row
+        short x; // First pixel with alpha
+        short count; // Pixel count (none with a null alpha)
+
+    } Span;
+    std::vector<Span> mSpans;
+
+    const unsigned char* mTexture; // Font texture buffer the overlay was built from (RGBA)
+    short mWidth;
+    short mHeight;
+
+    unsigned char* mPremul; // RGB * alpha / 255
+    unsigned char* mInverse; // 255 - alpha (per component)
+
+    boost::mutex mMutex;
+
+public:
+    LogoOverlay();
+    virtual ~LogoOverlay();
+
+    bool prepare(const unsigned char* texture, short texWidth, short left, short top, short width, short height);
+    // -> Build overlay from 'width' x 'height' texels at 'left' x 'top' position (only if 'texture' has changed)
+
+    inline short getWidth() const { return mWidth; }
+    inline short getHeight() const { return mHeight; }
+
+    //////
+    void blend(char* rgb, short rgbWidth, short left, short top);
+    // -> Blend overlay into 'rgb' buffer with 'rgbWidth' pixels per row at 'left' x 'top' position (nothing if not
+    //    prepared yet)
+
+};
+
+#endif // !PAID_VERSION
+#endif // LOGOOVERLAY_H_
@@ -7,11 +7,20 @@
 #ifdef __ANDROID__
 #include <boost/filesystem.hpp>
 #include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
 #include "Wifi/Connexion.h"
+#include "Video/CamFrame.h"
+#include "Video/PixelKernel.h"
+#include "Video/FrameCodec.h"
+#include "Video/BufferPool.h"
 
 #else
 #include <libGST/libGST.h>
 #include "Connexion.h"
+#include "CamFrame.h"
+#include "PixelKernel.h"
+#include "BufferPool.h"
 
 #endif
 
@@ -25,44 +34,65 @@
 #define LOGO_CORNER_POS             7 // In pixel (from the bottom right)
 #endif
 
+unsigned char Picture::mQuality = JPEG_QUALITY;
+#ifndef PAID_VERSION
+LogoOverlay Picture::mOverlay;
+#endif
+
 //////
 Picture::Picture() : mStatus(STATUS_EXTRACT), mSize(0), mFolder(NULL), mWalk(NULL), mAbort(true), mThread(NULL),
-mServer(false), mLandscape(true), mLand(NULL) {
+mServer(false), mLandscape(true), mLand(NULL), mWidth(CamFrame::getPreviewWidth()),
+mHeight(CamFrame::getPreviewHeight()), mEncodeTime(0) { // Preview resolution
     
     LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
 #ifndef PAID_VERSION
     mLogoBuffer = NULL;
 #endif
-    mData = new char[static_cast<int>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT) * 3];
-    mRGB = new char[CAM_WIDTH * CAM_HEIGHT * 3];
+#ifdef __ANDROID__
+    mCodec = NULL;
+#endif
+    mData = BufferPool::get(static_cast<size_t>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT * 3));
+    mRGB = BufferPool::get(static_cast<size_t>(mWidth * mHeight * 3));
 }
 Picture::Picture(bool server) : mServer(server), mStatus(STATUS_COMPRESS), mSize(0), mFolder(NULL), mData(NULL),
-        mWalk(NULL), mAbort(true), mThread(NULL), mLandscape(true), mRGB(NULL), mLand(NULL) {
+        mWalk(NULL), mAbort(true), mThread(NULL), mLandscape(true), mRGB(NULL), mLand(NULL),
+        mWidth(CamFrame::getWidth(true)), mHeight(CamFrame::getHeight(true)), mEncodeTime(0) { // Camera buffer
 
     LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
 #ifndef PAID_VERSION
     mLogoBuffer = NULL;
 #endif
+#ifdef __ANDROID__
+    mCodec = NULL;
+#endif
 }
 Picture::Picture(unsigned int size) : mStatus(STATUS_FILL), mSize(static_cast<int>(size)), mFolder(NULL), mAbort(true),
-        mThread(NULL), mServer(false), mLandscape(true), mRGB(NULL), mLand(NULL) {
+        mThread(NULL), mServer(false), mLandscape(true), mRGB(NULL), mLand(NULL), mWidth(CamFrame::getWidth()),
+        mHeight(CamFrame::getHeight()), mEncodeTime(0) {
 
     LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - s:%d"), __PRETTY_FUNCTION__, __LINE__, size);
     assert(mSize > 0);
-    mData = new char[size];
+    mData = BufferPool::get(size);
     mWalk = mData;
 #ifndef PAID_VERSION
     mLogoBuffer = NULL;
 #endif
+#ifdef __ANDROID__
+    mCodec = NULL;
+#endif
 }
 Picture::Picture(const std::string* folder) : mStatus(STATUS_RECORD), mServer(false), mSize(0), mFolder(folder),
-        mData(NULL), mWalk(NULL), mAbort(true), mThread(NULL), mLandscape(true), mRGB(NULL), mLand(NULL) {
+        mData(NULL), mWalk(NULL), mAbort(true), mThread(NULL), mLandscape(true), mRGB(NULL), mLand(NULL),
+        mWidth(CamFrame::getWidth()), mHeight(CamFrame::getHeight()), mEncodeTime(0) {
 
     LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - f:%x (%s)"), __PRETTY_FUNCTION__, __LINE__, folder,
             (folder)? folder->c_str():"null");
 #ifndef PAID_VERSION
     mLogoBuffer = NULL;
 #endif
+#ifdef __ANDROID__
+    mCodec = NULL;
+#endif
 }
 Picture::~Picture() {
 
@@ -73,29 +103,97 @@ Picture::~Picture() {
         mThread->join();
         delete mThread;
     }
-    if (mData)
-        delete [] mData;
-    if (mRGB)
-        delete [] mRGB;
-    if (mLand)
-        delete [] mLand;
+    BufferPool::release(mData);
+    BufferPool::release(mRGB);
+    BufferPool::release(mLand);
 }
 
 std::string Picture::getFileName(const std::string* folder, const char* extension, unsigned char client) {
 
     LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - c:%d"), __PRETTY_FUNCTION__, __LINE__, client);
-    std::string fileName(*folder);
-    fileName.append(MCAM_SUB_FOLDER);
-    fileName.append(PIC_FILE_NAME);
-    switch (DIGIT_COUNT(client)) {
-        case 1: fileName.append("00"); break;
-        case 2: fileName += '0'; break;
-    }
-    fileName.append(numToStr<short>(static_cast<short>(client)));
-    fileName.append(extension);
-    return fileName;
+    FramePath path(folder);
+    return std::string(path.getClient(client, extension));
 }
 
+#ifdef __ANDROID__
+bool Picture::gstPush(const std::string &pipeline, char* data, size_t size, char** out, int* outSize) {
+
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - p:%s; d:%x; s:%d; o:%x"), __PRETTY_FUNCTION__, __LINE__, pipeline.c_str(),
+            data, size, out);
+    assert((!out) || (outSize));
+    GError* error = NULL;
+    GstElement* launch = gst_parse_launch(pipeline.c_str(), &error);
+    if (error) {
+
+        LOGE(LOG_FORMAT(" - gStreamer error: %s"), __PRETTY_FUNCTION__, __LINE__, error->message);
+        g_clear_error(&error);
+        assert(NULL);
+        return false;
+    }
+    GstElement* frame = gst_bin_get_by_name(GST_BIN(launch), "frame");
+    assert(frame);
+    gst_element_set_state(launch, GST_STATE_PLAYING);
+
+    // Push buffer without copy (valid until EOS)
+    gst_app_src_push_buffer(GST_APP_SRC(frame), gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, data, size, 0,
+            size, NULL, NULL));
+    gst_app_src_end_of_stream(GST_APP_SRC(frame));
+    gst_object_unref(frame);
+
+    bool done = true;
+    if (out) { // Pull result
+
+        GstElement* output = gst_bin_get_by_name(GST_BIN(launch), "output");
+        assert(output);
+        GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(output)); // NULL if EOS or error
+        gst_object_unref(output);
+
+        *out = NULL;
+        *outSize = 0;
+        if (sample) {
+
+            GstMapInfo info;
+            GstBuffer* buffer = gst_sample_get_buffer(sample);
+            if ((buffer) && (gst_buffer_map(buffer, &info, GST_MAP_READ))) {
+
+                try { *out = BufferPool::get(info.size); }
+                catch (const std::bad_alloc &e) {
+                    LOGW(LOG_FORMAT(" - Failed to allocate %d bytes"), __PRETTY_FUNCTION__, __LINE__, info.size);
+                }
+                if (*out) {
+
+                    memcpy(*out, info.data, info.size);
+                    *outSize = static_cast<int>(info.size);
+                }
+                gst_buffer_unmap(buffer, &info);
+            }
+            gst_sample_unref(sample);
+        }
+        if (!(*out))
+            done = false;
+    }
+
+    // Wait EOS
+    GstMessage* msg = gst_bus_poll(gst_element_get_bus(launch), (GstMessageType)(GST_MESSAGE_ERROR | GST_MESSAGE_EOS), -1);
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+
+        GError* err = NULL;
+        gchar* dbg = NULL;
+        gst_message_parse_error(msg, &err, &dbg);
+        if (err) {
+
+            LOGE(LOG_FORMAT(" - gStreamer error: %s (%s)"), __PRETTY_FUNCTION__, __LINE__, err->message,
+                    (dbg)? dbg:"none");
+            g_error_free(err);
+        }
+        done = false;
+    }
+    gst_message_unref(msg);
+    gst_element_set_state(launch, GST_STATE_NULL);
+    gst_object_unref(GST_OBJECT(launch));
+    return done;
+}
+#endif
 #ifdef DEBUG
 bool Picture::gstLaunch(const std::string &pipeline, bool crash) {
 
@@ -211,76 +309,41 @@ signed char Picture::fill(const ClientMgr* mgr) {
 
 void Picture::orientation(bool land2port) {
 
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s"), __PRETTY_FUNCTION__, __LINE__, (land2port)? "true":"false");
-
-    char* buffer = mData;
-    unsigned char pixel = 4;
-    if (mStatus == STATUS_EXTRACT) { // RGB
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s (w:%d; h:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            (land2port)? "true":"false", mWidth, mHeight);
 
-        assert(mRGB);
-        assert(mSize == (CAM_WIDTH * CAM_HEIGHT * 3));
-
-        buffer = mRGB;
-        pixel = 3;
-    }
-#ifdef DEBUG
-    else { // RGBA
+    assert(mStatus == STATUS_EXTRACT);
+    assert(mRGB);
+    assert(mSize == (mWidth * mHeight * 3));
 
-        assert(mData);
-        assert(mSize == (CAM_WIDTH * CAM_HEIGHT * 4));
-    }
-#endif
     if (!mLand)
-        mLand = new char[mSize];
-    std::memcpy(mLand, buffer, mSize);
-
-    for (short xPort = 0, xLand = 0; xPort < CAM_WIDTH; ++xPort, ++xLand) {
-        for (short yPort = 0, yLand = (CAM_HEIGHT - 1); yPort < CAM_HEIGHT; ++yPort, --yLand) {
+        mLand = BufferPool::get(static_cast<size_t>(mSize)); // Kept from frame to frame
 
-            int iPort = ((xPort * CAM_HEIGHT) + yPort) * pixel;
-            int iLand = ((yLand * CAM_WIDTH) + xLand) * pixel;
+    // Rotate out-of-place then swap buffers (no copy)
+    PixelKernel::rotate(mLand, mRGB, mWidth, mHeight, land2port);
+    std::swap<char*>(mRGB, mLand);
+}
 
-            if (!land2port) // From portrait to landscape
-                std::swap<int>(iPort, iLand);
-            //else // From landscape to portrait
+void Picture::pack(const char* src, bool bgra) {
 
-            buffer[iPort + 0] = mLand[iLand + 0];
-            buffer[iPort + 1] = mLand[iLand + 1];
-            buffer[iPort + 2] = mLand[iLand + 2];
-            //buffer[i + 3] = 0xff;
-        }
-    }
-}
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - s:%x; b:%s (l:%s)"), __PRETTY_FUNCTION__, __LINE__, src,
+            (bgra)? "true":"false", (mLandscape)? "true":"false");
+    assert(src);
+    if (!mRGB)
+        mRGB = BufferPool::get(static_cast<size_t>(mWidth * mHeight * 3));
 
+    PixelKernel::record(mRGB, src, mWidth, mHeight, mLandscape, bgra);
 #ifndef PAID_VERSION
-void Picture::insert() {
+    assert(mLogoBuffer); // Overlay prepared by the caller thread (see 'prepareLogo')
 
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
-    assert(mData);
-    assert(mSize == (CAM_WIDTH * CAM_HEIGHT * 4));
-
-    short camWidth = CAM_WIDTH;
-    short camHeight = CAM_HEIGHT;
-    if (!mLandscape)
-        std::swap<short>(camWidth, camHeight);
-
-    int xData = ((camHeight - LOGO_CORNER_POS - LOGO_HEIGHT) * camWidth * 4) + ((camWidth - LOGO_CORNER_POS -
-            LOGO_WIDTH) * 4);
-    int xLogo = (LOGO_Y0 * static_cast<int>(FONT_TEX_WIDTH) * 4) + (LOGO_X0 * 4);
-    for (short y = 0; y < LOGO_HEIGHT; ++y) {
-        for (short x = 0; x < LOGO_WIDTH; ++x) {
-
-            int i = ((y * LOGO_WIDTH) + x) * 4;
-
-            float alpha = mLogoBuffer[i + xLogo + 3] / MAX_COLOR;
-            mData[i + xData + 0] = mData[i + xData + 0] - (mData[i + xData + 0] * alpha) + (mLogoBuffer[i + xLogo + 0] * alpha);
-            mData[i + xData + 1] = mData[i + xData + 1] - (mData[i + xData + 1] * alpha) + (mLogoBuffer[i + xLogo + 1] * alpha);
-            mData[i + xData + 2] = mData[i + xData + 2] - (mData[i + xData + 2] * alpha) + (mLogoBuffer[i + xLogo + 2] * alpha);
-            //mData[i + xData + 3] = 0xff;
-        }
-        xData += (camWidth - LOGO_WIDTH) * 4;
-        xLogo += (static_cast<int>(FONT_TEX_WIDTH) - LOGO_WIDTH) * 4;
-    }
+    short width = (mLandscape)? mWidth:mHeight; // Encoded frame resolution
+    short height = (mLandscape)? mHeight:mWidth;
+    mOverlay.blend(mRGB, width, width - LOGO_CORNER_POS - LOGO_WIDTH, height - LOGO_CORNER_POS - LOGO_HEIGHT);
+#endif
+}
+#ifndef PAID_VERSION
+bool Picture::prepareLogo(const unsigned char* logo) {
+    return mOverlay.prepare(logo, static_cast<short>(FONT_TEX_WIDTH), LOGO_X0, LOGO_Y0, LOGO_WIDTH, LOGO_HEIGHT);
 }
 #endif
 
@@ -316,22 +379,13 @@ bool Picture::store(const char* extension, size_t size, short client) const {
             client, mStatus);
     assert(mFolder);
 
-    std::string fileName;
-    if (mStatus != STATUS_RECORD)
-        fileName.assign(getFileName(mFolder, extension, static_cast<unsigned char>(client)));
-
-    else { // STATUS_RECORD
-
-        fileName.assign(*mFolder);
-        fileName.append(MCAM_SUB_FOLDER);
-        fileName.append(PIC_FILE_NAME);
-        fileName.append(numToStr<short>(client));
-        fileName.append(extension);
-    }
-    FILE* file = fopen(fileName.c_str(), "wb");
+    FramePath path(mFolder);
+    const char* fileName = (mStatus != STATUS_RECORD)? path.getClient(static_cast<unsigned char>(client), extension):
+            path.get(client, extension); // STATUS_RECORD
+    FILE* file = fopen(fileName, "wb");
     if (!file) {
 
-        LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
+        LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
         assert(NULL);
         return false;
     }
@@ -339,7 +393,7 @@ bool Picture::store(const char* extension, size_t size, short client) const {
 
         fclose(file);
         LOGE(LOG_FORMAT(" - Failed to write %d bytes into file %s"), __PRETTY_FUNCTION__, __LINE__, size,
-                fileName.c_str());
+                fileName);
         assert(NULL);
         return false;
     }
@@ -347,6 +401,26 @@ bool Picture::store(const char* extension, size_t size, short client) const {
     return true;
 }
 
+#ifdef __ANDROID__
+bool Picture::encode(const char* rgb, short width, short height, const char* file, char** out, int* outSize) {
+
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - r:%x; w:%d; h:%d; f:%s; o:%x (q:%d; c:%x)"), __PRETTY_FUNCTION__, __LINE__,
+            rgb, width, height, (file)? file:"null", out, mQuality, mCodec);
+    unsigned int begin = CamFrame::now();
+
+    FrameCodec once;
+    FrameCodec* codec = (mCodec)? mCodec:&once;
+    if (!codec->open(FrameCodec::CODEC_ENCODE, width, height, mQuality)) // Already opened if session pre-warmed
+        return false;
+
+    bool done = codec->encode(rgb, file, out, outSize);
+    mEncodeTime = CamFrame::now() - begin;
+    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - JPEG encoded in %u ms (%dx%d)"), __PRETTY_FUNCTION__, __LINE__, mEncodeTime,
+            width, height);
+    return done;
+}
+#endif
+
 #ifndef PAID_VERSION
 void Picture::save(const unsigned char* logo, bool landscape, unsigned char client) {
 
@@ -366,6 +440,7 @@ void Picture::save(bool landscape, unsigned char client) {
 #ifndef PAID_VERSION
             assert(logo);
             mLogoBuffer = logo;
+            prepareLogo(logo); // Before starting the conversion thread
 #endif
             assert(!mThread);
             mAbort = false;
@@ -401,114 +476,119 @@ void Picture::save(bool landscape, unsigned char client) {
 }
 
 #ifndef PAID_VERSION
-bool Picture::record(const unsigned char* logo, bool landscape, short client) {
+bool Picture::record(const unsigned char* logo, bool landscape, short client, char* rgba, bool compress) {
 
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%x; l:%s; c:%d (s:%d)"), __PRETTY_FUNCTION__, __LINE__, logo,
-            (landscape)? "true":"false", client, mStatus);
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%x; l:%s; c:%d; r:%x; c:%s (s:%d)"), __PRETTY_FUNCTION__, __LINE__, logo,
+            (landscape)? "true":"false", client, rgba, (compress)? "true":"false", mStatus);
     mLogoBuffer = logo;
 #else
-bool Picture::record(bool landscape, unsigned char client) {
+bool Picture::record(bool landscape, short client, char* rgba, bool compress) {
 
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s; c:%d (s:%d)"), __PRETTY_FUNCTION__, __LINE__,
-            (landscape)? "true":"false", client, mStatus);
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s; c:%d; r:%x; c:%s (s:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            (landscape)? "true":"false", client, rgba, (compress)? "true":"false", mStatus);
 #endif
     assert(mStatus == STATUS_RECORD);
 
     mLandscape = landscape;
 
     // Fill buffer from BIN file (BGRA/RGBA)
-    std::string fileName(*mFolder);
-    fileName.append(MCAM_SUB_FOLDER);
-    fileName.append(PIC_FILE_NAME);
-    fileName.append(numToStr<short>(client));
-    fileName.append(BIN_FILE_EXTENSION);
-    if (!open(fileName)) {
-
-        remove(fileName.c_str()); // Delete BIN file
-        return false;
-    }
-
-#ifndef __ANDROID__
-    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert BGRA to RGBA"), __PRETTY_FUNCTION__, __LINE__);
+    FramePath binPath(mFolder);
+    const char* fileName = binPath.get(client, BIN_FILE_EXTENSION);
+    if (rgba) { // ...or use the recorder frame buffer (kept in RAM)
 
-    char* rgba;
-    try { rgba = new char[CAM_HEIGHT * CAM_WIDTH * 4]; }
-    catch (const std::bad_alloc &e) {
+        mData = rgba;
+        mSize = mWidth * mHeight * 4;
+    }
+    else if (!open(fileName)) {
 
-        LOGW(LOG_FORMAT(" - Failed to allocate RGBA buffer"), __PRETTY_FUNCTION__, __LINE__);
+        remove(fileName); // Delete BIN file
         return false;
     }
-    // Convert from BGRA to RGBA (ARGB)
-    for (int y = 0, pix = 0; y < CAM_HEIGHT; ++y)
-        for (int x = 0; x < CAM_WIDTH; ++x, pix += 4) {
-
-            rgba[pix] = mData[pix + 2];
-            rgba[pix + 1] = mData[pix + 1];
-            rgba[pix + 2] = mData[pix];
-            rgba[pix + 3] = mData[pix + 3];
-        }
 
-    delete [] mData;
-    mData = rgba;
+    // Swizzle (BGRA on iOS), rotate & blend logo into RGB buffer in a single pass
+#ifdef __ANDROID__
+    pack(mData, false);
+#else
+    pack(mData, true);
 #endif
+    if (!rgba)
+        BufferPool::release(mData);
+    mData = NULL; // Avoid to delete recorder frame buffer
+    mSize = mWidth * mHeight * 3;
 
-    if (!mLandscape)
-        orientation(true); // From landscape to portrait
-
-#ifndef PAID_VERSION
-    // Add logo
-    insert();
-#endif
+#ifdef __ANDROID__
+    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert buffer into JPEG"), __PRETTY_FUNCTION__, __LINE__);
+    char* jpeg = NULL;
+    int jpegSize = 0;
+    bool done;
+    if (compress)
+        done = encode(mRGB, (mLandscape)? mWidth:mHeight, (mLandscape)? mHeight:mWidth, NULL, &jpeg, &jpegSize);
+    else {
+
+        FramePath jpegPath(mFolder);
+        done = encode(mRGB, (mLandscape)? mWidth:mHeight, (mLandscape)? mHeight:mWidth,
+                jpegPath.get(client, JPEG_FILE_EXTENSION));
+    }
+    if (!rgba) {
 
+        LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Delete BIN file (%s)"), __PRETTY_FUNCTION__, __LINE__, fileName);
+        remove(fileName);
+    }
+    mData = jpeg; // JPEG buffer (if compressed)
+    mSize = jpegSize;
+#else
     // Save into BIN
-    if (!store(BIN_FILE_EXTENSION, static_cast<size_t>(mSize), client)) {
+    mData = mRGB;
+    bool done = store(BIN_FILE_EXTENSION, static_cast<size_t>(mSize), client);
+    mData = NULL;
+    if (done) {
 
-        remove(fileName.c_str());
-        return false;
+        LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert BIN into JPEG"), __PRETTY_FUNCTION__, __LINE__);
+        std::string pipeline("filesrc location=");
+        pipeline.append(fileName);
+        pipeline.append(" blocksize=");
+        pipeline.append(numToStr<int>(mSize)); // Size
+        pipeline.append(" ! video/x-raw,format=RGB,width=");
+        if (mLandscape)
+            pipeline.append(numToStr<short>(mWidth));
+        else
+            pipeline.append(numToStr<short>(mHeight));
+        pipeline.append(",height=");
+        if (mLandscape)
+            pipeline.append(numToStr<short>(mHeight));
+        else
+            pipeline.append(numToStr<short>(mWidth));
+        pipeline.append(",framerate=1/1 ! jpegenc ! filesink location=");
+        FramePath jpegPath(mFolder);
+        pipeline.append(jpegPath.get(client, JPEG_FILE_EXTENSION));
+
+        done = gstLaunch(pipeline);
     }
-    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert BIN into JPEG"), __PRETTY_FUNCTION__, __LINE__);
-    std::string pipeline("filesrc location=");
-    pipeline.append(fileName);
-    pipeline.append(" blocksize=");
-    pipeline.append(numToStr<int>(mSize)); // Size
-    pipeline.append(" ! video/x-raw,format=RGBA,width=");
-    if (mLandscape)
-        pipeline.append(numToStr<short>(CAM_WIDTH));
-    else
-        pipeline.append(numToStr<short>(CAM_HEIGHT));
-    pipeline.append(",height=");
-    if (mLandscape)
-        pipeline.append(numToStr<short>(CAM_HEIGHT));
-    else
-        pipeline.append(numToStr<short>(CAM_WIDTH));
-    pipeline.append(",framerate=1/1 ! videoconvert ! video/x-raw,format=RGB,framerate=1/1 ! jpegenc ! filesink location=");
-    pipeline.append(*mFolder);
-    pipeline.append(MCAM_SUB_FOLDER);
-    pipeline.append(PIC_FILE_NAME);
-    pipeline.append(numToStr<short>(client));
-    pipeline.append(JPEG_FILE_EXTENSION);
+    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Delete BIN file (%s)"), __PRETTY_FUNCTION__, __LINE__, fileName);
+    remove(fileName);
 
-    if (!gstLaunch(pipeline)) {
+    mSize = 0;
+    if ((done) && (compress)) { // Load JPEG file into buffer (no 'appsink' with 'lib_gst_launch')
 
-        remove(fileName.c_str());
-        return false;
+        fileName = binPath.get(client, JPEG_FILE_EXTENSION);
+        done = open(fileName);
+        remove(fileName);
     }
-    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Delete BIN file (%s)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
-    remove(fileName.c_str());
-    return true;
+#endif
+    return done;
 }
 
-bool Picture::open(const std::string &fileName) {
+bool Picture::open(const char* fileName) {
 
 #ifdef DEBUG
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - f:%s (s:%d)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str(), mStatus);
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - f:%s (s:%d)"), __PRETTY_FUNCTION__, __LINE__, fileName, mStatus);
     if (mStatus != STATUS_EXTRACT)
         assert(!mData);
 #endif
-    std::ifstream ifs(fileName.c_str(), std::ifstream::binary);
+    std::ifstream ifs(fileName, std::ifstream::binary);
     if (!ifs.is_open()) {
 
-        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
+        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
         mStatus = STATUS_ERROR;
         assert(NULL);
         return false;
@@ -518,12 +598,12 @@ bool Picture::open(const std::string &fileName) {
 #ifdef DEBUG
     LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
     if (mStatus == STATUS_EXTRACT)
-        assert(mSize == (CAM_WIDTH * CAM_HEIGHT * 3)); // RGB
+        assert(mSize == (mWidth * mHeight * 3)); // RGB
 #endif
     if (mSize < 1) {
 
         ifs.close();
-        LOGE(LOG_FORMAT(" - Wrong %s file size (%d)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str(), mSize);
+        LOGE(LOG_FORMAT(" - Wrong %s file size (%d)"), __PRETTY_FUNCTION__, __LINE__, fileName, mSize);
         mStatus = STATUS_ERROR;
         assert(NULL);
         return false;
@@ -531,7 +611,7 @@ bool Picture::open(const std::string &fileName) {
     pbuf->pubseekpos(0, ifs.in);
     if (!mData) {
 
-        try { mData = new char[mSize]; }
+        try { mData = BufferPool::get(static_cast<size_t>(mSize)); }
         catch (const std::bad_alloc &e) {
 
             LOGW(LOG_FORMAT(" - Failed to allocate data buffer"), __PRETTY_FUNCTION__, __LINE__);
@@ -549,26 +629,46 @@ bool Picture::open(const std::string &fileName) {
     return true;
 }
 
-bool Picture::extract(bool landscape, short frame) {
+bool Picture::extract(bool landscape, short frame, unsigned char client) {
 
-    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s; f:%d (s:%d; d:%x; l:%d; r:%x)"), __PRETTY_FUNCTION__, __LINE__,
-         (landscape)? "true":"false", frame, mStatus, mData, mSize, mRGB);
+    LOGV(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - l:%s; f:%d; c:%d (s:%d; d:%x; l:%d; r:%x)"), __PRETTY_FUNCTION__,
+         __LINE__, (landscape)? "true":"false", frame, client, mStatus, mData, mSize, mRGB);
     assert(mStatus == STATUS_EXTRACT);
     assert(mFolder);
     assert(mData);
     assert(mRGB);
 
-    std::string fileName(getFileName(mFolder, JPEG_FILE_EXTENSION));
-    fileName.resize(fileName.size() - 7); // '000.jpg' contains 7 characters
-    fileName.append(numToStr<short>(frame));
-    fileName.append(JPEG_FILE_EXTENSION);
+    FramePath path(mFolder);
+    const char* fileName = path.getSource(frame, client, JPEG_FILE_EXTENSION);
+
+#ifdef __ANDROID__
+    // Uncompress from JPEG to RGB (downscaled to preview resolution)
+    unsigned int begin = CamFrame::now();
+    FrameCodec once;
+    FrameCodec* codec = (mCodec)? mCodec:&once;
+    if ((!codec->open(FrameCodec::CODEC_DECODE, (landscape)? mWidth:mHeight, (landscape)? mHeight:mWidth,
+            CamFrame::getPreviewScale())) || (!codec->decode(fileName, mRGB)))
+        return false;
 
+    LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - JPEG decoded in %u ms"), __PRETTY_FUNCTION__, __LINE__,
+            CamFrame::now() - begin);
+    mSize = mWidth * mHeight * 3;
+#else
     // Uncompress from JPEG to RGB (to BIN file)
     std::string pipeline("filesrc location=");
     pipeline.append(fileName);
-    pipeline.append(" ! jpegdec ! videoconvert ! video/x-raw,format=RGB ! filesink location=");
-    fileName.resize(fileName.size() - sizeof(JPEG_FILE_EXTENSION) + 1);
-    fileName.append(BIN_FILE_EXTENSION);
+    pipeline.append(" ! jpegdec ! videoconvert ! ");
+    if (CamFrame::getPreviewScale() > 1) { // Downscale to preview resolution
+
+        pipeline.append("videoscale ! video/x-raw,format=RGB,width=");
+        pipeline.append(numToStr<short>((landscape)? mWidth:mHeight));
+        pipeline.append(",height=");
+        pipeline.append(numToStr<short>((landscape)? mHeight:mWidth));
+    }
+    else
+        pipeline.append("video/x-raw,format=RGB");
+    pipeline.append(" ! filesink location=");
+    fileName = path.getSource(frame, client, BIN_FILE_EXTENSION);
     pipeline.append(fileName);
 
     if (!gstLaunch(pipeline))
@@ -579,39 +679,28 @@ bool Picture::extract(bool landscape, short frame) {
         return false;
 
     LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
-    assert(mSize == (CAM_WIDTH * CAM_HEIGHT * 3));
+    assert(mSize == (mWidth * mHeight * 3));
 
-    std::memcpy(mRGB, mData, CAM_WIDTH * CAM_HEIGHT * 3);
+    std::memcpy(mRGB, mData, mWidth * mHeight * 3);
+    fileName = path.getSource(frame, client, JPEG_FILE_EXTENSION);
+#endif
     if (!landscape)
         orientation(false); // From portrait to landscape
 
     // Put RGB buffer into a video texture buffer (64 texels)
-    int xLag = 0;
-    for (short y = 0; y < CAM_HEIGHT; ++y) {
-        for (short x = 0; x < CAM_WIDTH; ++x) {
-
-            int i = ((y * CAM_WIDTH) + x) * 3;
-            mData[i + xLag + 0] = mRGB[i + 0];
-            mData[i + xLag + 1] = mRGB[i + 1];
-            mData[i + xLag + 2] = mRGB[i + 2];
-        }
-        xLag += static_cast<int>(CAM_TEX_WIDTH - CAM_WIDTH) * 3;
-    }
+    PixelConvert::pad(mData, mRGB, mWidth, mHeight, static_cast<short>(CAM_TEX_WIDTH));
     mSize = static_cast<int>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT) * 3;
 
     // Save it into BIN file
-    mStatus = STATUS_RECORD;
-    if (!store(BIN_FILE_EXTENSION, static_cast<size_t>(mSize), frame)) {
-
-        mStatus = STATUS_EXTRACT;
-        return false;
-    }
+    if (!client)
+        mStatus = STATUS_RECORD; // 'img_<frame>.bin' instead of 'img_<000>.bin' (see 'store')
+    bool done = store(BIN_FILE_EXTENSION, static_cast<size_t>(mSize), (client)? client:frame);
     mStatus = STATUS_EXTRACT;
+    if (!done)
+        return false;
 
     // Delete JPEG file
-    fileName.resize(fileName.size() - sizeof(BIN_FILE_EXTENSION) + 1);
-    fileName.append(JPEG_FILE_EXTENSION);
-    remove(fileName.c_str());
+    remove(fileName);
 
     return true;
 }
@@ -622,29 +711,54 @@ void Picture::processThreadRunning() {
     assert(mStatus == STATUS_COMPRESS);
     assert(mFolder);
 
+    unsigned int sequence = CamFrame::getSequence();
     while (!mAbort) {
 
         Camera* camera = Camera::getInstance();
         if (!camera->isBuffered()) {
 
-            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+            sequence = CamFrame::wait(sequence, CAMERA_WAIT_TIMEOUT); // Frame arrival event (or timeout)
             continue;
         }
 
         // Camera buffer is ready so convert it into JPEG
-        mData = const_cast<char*>(camera->getBuffer());
-        mSize = camera->getBufferLen();
+        LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert RGBA to JPEG (frame #%u)"), __PRETTY_FUNCTION__, __LINE__,
+                CamFrame::getSequence());
+        pack(camera->getBuffer(), false); // Orientation & logo (camera buffer unchanged)
+        mSize = mWidth * mHeight * 3;
 
-        LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Convert RGBA to JPEG"), __PRETTY_FUNCTION__, __LINE__);
-        if (!mLandscape)
-            orientation(true); // From landscape to portrait
-
-#ifndef PAID_VERSION
-        // Add logo
-        insert();
-#endif
         createPath(mFolder);
-        if (!store(BIN_FILE_EXTENSION, camera->getBufferLen())) { // Save into BIN file
+#ifdef __ANDROID__
+        bool done;
+        std::string jpegFile(getFileName(mFolder, JPEG_FILE_EXTENSION));
+        if ((mWidth == CamFrame::getWidth()) && (mHeight == CamFrame::getHeight()))
+            done = encode(mRGB, (mLandscape)? mWidth:mHeight, (mLandscape)? mHeight:mWidth, jpegFile.c_str());
+
+        else { // Scale to session resolution
+
+            LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Scale %dx%d to %dx%d"), __PRETTY_FUNCTION__, __LINE__, mWidth,
+                    mHeight, CamFrame::getWidth(), CamFrame::getHeight());
+            std::string pipeline("appsrc name=frame caps=\"video/x-raw,format=RGB,width=");
+            pipeline.append(numToStr<short>((mLandscape)? mWidth:mHeight));
+            pipeline.append(",height=");
+            pipeline.append(numToStr<short>((mLandscape)? mHeight:mWidth));
+            pipeline.append(",framerate=1/1\" ! videoscale ! video/x-raw,format=RGB,width=");
+            pipeline.append(numToStr<short>((mLandscape)? CamFrame::getWidth():CamFrame::getHeight()));
+            pipeline.append(",height=");
+            pipeline.append(numToStr<short>((mLandscape)? CamFrame::getHeight():CamFrame::getWidth()));
+            pipeline.append(",framerate=1/1 ! jpegenc quality=");
+            pipeline.append(numToStr<short>(static_cast<short>(mQuality)));
+            pipeline.append(" ! filesink location=");
+            pipeline.append(jpegFile);
+
+            done = gstPush(pipeline, mRGB, static_cast<size_t>(mSize));
+        }
+        if (!done) {
+#else
+        mData = mRGB;
+        bool done = store(BIN_FILE_EXTENSION, static_cast<size_t>(mSize)); // Save into BIN file
+        mData = NULL;
+        if (!done) {
 
             mAbort = true;
             mStatus = STATUS_ERROR;
@@ -656,30 +770,41 @@ void Picture::processThreadRunning() {
         pipeline.append(PIC_FILE_NAME);
         pipeline.append("000.bin blocksize="); // Client + Extension
         pipeline.append(numToStr<int>(mSize)); // Size
-        pipeline.append(" ! video/x-raw,format=RGBA,width=");
+        pipeline.append(" ! video/x-raw,format=RGB,width=");
         if (mLandscape)
-            pipeline.append(numToStr<short>(CAM_WIDTH));
+            pipeline.append(numToStr<short>(mWidth));
         else
-            pipeline.append(numToStr<short>(CAM_HEIGHT));
+            pipeline.append(numToStr<short>(mHeight));
         pipeline.append(",height=");
         if (mLandscape)
-            pipeline.append(numToStr<short>(CAM_HEIGHT));
+            pipeline.append(numToStr<short>(mHeight));
         else
-            pipeline.append(numToStr<short>(CAM_WIDTH));
-        pipeline.append(",framerate=1/1 ! videoconvert ! video/x-raw,format=RGB,framerate=1/1 ! jpegenc ! filesink location=");
+            pipeline.append(numToStr<short>(mWidth));
+        pipeline.append(",framerate=1/1 ! ");
+        if ((mWidth != CamFrame::getWidth()) || (mHeight != CamFrame::getHeight())) { // Scale to session resolution
+
+            LOGI(LOG_LEVEL_PICTURE, 0, LOG_FORMAT(" - Scale %dx%d to %dx%d"), __PRETTY_FUNCTION__, __LINE__, mWidth,
+                    mHeight, CamFrame::getWidth(), CamFrame::getHeight());
+            pipeline.append("videoscale ! video/x-raw,format=RGB,width=");
+            pipeline.append(numToStr<short>((mLandscape)? CamFrame::getWidth():CamFrame::getHeight()));
+            pipeline.append(",height=");
+            pipeline.append(numToStr<short>((mLandscape)? CamFrame::getHeight():CamFrame::getWidth()));
+            pipeline.append(",framerate=1/1 ! jpegenc ! filesink location=");
+        }
+        else
+            pipeline.append("jpegenc ! filesink location=");
         pipeline.append(*mFolder);
         pipeline.append(MCAM_SUB_FOLDER);
         pipeline.append(PIC_FILE_NAME);
         pipeline.append("000.jpg");
 
         if (!gstLaunch(pipeline)) {
-
+#endif
             mAbort = true;
             mStatus = STATUS_ERROR;
             break; // Error
         }
-        mData = NULL; // Avoid to delete buffer (let's camera delete it)
-        if ((!mServer) && (!open(getFileName(mFolder, JPEG_FILE_EXTENSION)))) // Do not open it for server
+        if ((!mServer) && (!open(getFileName(mFolder, JPEG_FILE_EXTENSION).c_str()))) // Do not open it for server
             break;
 
         mAbort = true;
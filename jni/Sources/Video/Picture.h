@@ -10,13 +10,14 @@
 
 #ifdef __ANDROID__
 #include "Wifi/ClientMgr.h"
+#include "Video/LogoOverlay.h"
+#include "Video/FramePath.h"
 #else
 #include "ClientMgr.h"
+#include "LogoOverlay.h"
+#include "FramePath.h"
 #endif
 
-#define MCAM_SUB_FOLDER         "/MCAM"
-#define PIC_FILE_NAME           "/img_"
-
 #define JPEG_FILE_EXTENSION     ".jpg"
 #define BIN_FILE_EXTENSION      ".bin"
 #ifdef __ANDROID__
@@ -25,11 +26,18 @@
 #define AAC_FILE_EXTENSION      ".aac"
 #endif
 
+#define JPEG_QUALITY            85 // Default JPEG quality [0;100] (same as 'jpegenc')
+#define CAMERA_WAIT_TIMEOUT     100 // Camera frame wait (in milliseconds): No frame event on iOS (see 'CamFrame::wait')
+
 #define CHECKSUM_LEN            3 // In byte (1024 * 255 = 261120 = 3FC00 -> 3 bytes)
 #define SECURITY_LEN            2 // ... (65535 = FFFF -> 2 bytes)
 
 using namespace eng;
 
+#ifdef __ANDROID__
+class FrameCodec;
+#endif
+
 //////
 class Picture {
 
@@ -41,10 +49,15 @@ private:
     char* mLand;
 
     int mSize; // Max signed integer > 640*480*4*((255*2*2)+(7*9)+(3*9)) == 1'363'968'000
+    short mWidth; // Frame resolution (landscape)
+    short mHeight; // ...
 
     bool mServer;
     bool mLandscape;
 
+    static unsigned char mQuality; // JPEG quality
+    unsigned int mEncodeTime; // Last JPEG encoding duration (in milliseconds)
+
     volatile bool mAbort;
     boost::thread* mThread;
 
@@ -59,16 +72,13 @@ private:
         STATUS_COMPRESS, // Compress from camera buffer to JPEG file (see constructors)
         STATUS_FILL, // Create JPEG file from downloaded client buffer (see constructors & 'retry' method)
         STATUS_RECORD,
-        // -> Fill buffer from BIN file (BGRA/RGBA)
-        // -> Convert BGRA to RGBA (if needed)
-        // -> Add logo (if needed)
-        // -> Save into BIN
-        // -> Convert BIN into JPEG
+        // -> Fill buffer from BIN file (BGRA/RGBA) or use the recorder frame buffer
+        // -> Convert BGRA/RGBA to RGB with orientation & logo (if needed) in a single pass (see 'pack')
+        // -> Convert RGB into JPEG (through a BIN file on iOS)
         // -> Delete BIN file
 
         STATUS_EXTRACT // See constructors
-        // -> Uncompress JPEG file into a BIN file
-        // -> Read BIN file to get RGB buffer
+        // -> Uncompress JPEG file into RGB buffer at preview resolution (see 'CamFrame::getPreviewScale')
         // -> Apply orientation (into RGB buffer)
         // -> Convert RGB buffer into a 64 texels buffer
         // -> Save it into BIN file
@@ -91,27 +101,55 @@ public:
 #else
     static bool gstLaunch(const std::string &pipeline);
 #endif
+#ifdef __ANDROID__
+    static bool gstPush(const std::string &pipeline, char* data, size_t size, char** out = NULL, int* outSize = NULL);
+    // -> Push buffer into 'appsrc' named 'frame' (and pull result from 'appsink' named 'output' if 'out' is not NULL)
+#endif
 
     inline void setFolder(const std::string* folder) { mFolder = folder; }
     inline bool isDone() const { return (mStatus == STATUS_OK); }
     inline bool isError() const { return (mStatus == STATUS_ERROR); }
 
+    static inline void setQuality(unsigned char quality) { mQuality = (quality > 100)? 100:quality; }
+    static inline unsigned char getQuality() { return mQuality; }
+    inline unsigned int getEncodeTime() const { return mEncodeTime; }
+#ifdef __ANDROID__
+    inline void setCodec(FrameCodec* codec) { mCodec = codec; } // Reuse codec session (one thread at a time)
+#endif
+#ifndef PAID_VERSION
+    static bool prepareLogo(const unsigned char* logo); // Premultiplied logo overlay from font texture (once per take)
+#endif
+
 private:
 #ifndef PAID_VERSION
     const unsigned char* mLogoBuffer;
-
-    void insert(); // Insert MCAM logo into buffer
+    static LogoOverlay mOverlay;
 #endif
-    void orientation(bool land2port); // Convert buffer from portrait/landscape to landscape/portrait
+    void pack(const char* src, bool bgra); // Camera frame into RGB buffer with orientation & MCAM logo (single pass)
+    void orientation(bool land2port); // Rotate RGB buffer from portrait/landscape to landscape/portrait (tiled)
 
     bool store(const char* extension, size_t size, short client = 0) const;
-    bool open(const std::string &fileName); // Fill buffer from local JPEG/BIN file (no passing parameter by reference)
+#ifdef __ANDROID__
+    FrameCodec* mCodec; // Codec session (NULL: Codec opened for one frame only)
+
+    bool encode(const char* rgb, short width, short height, const char* file, char** out = NULL,
+            int* outSize = NULL);
+    // -> Compress RGB buffer into JPEG 'file' (or into 'out' buffer if 'file' is NULL)
+#endif
+    bool open(const char* fileName); // Fill buffer from local JPEG/BIN file
 
     //////
 public:
     static std::string getFileName(const std::string* folder, const char* extension, unsigned char client = 0);
 
     inline unsigned int getSize() const { return static_cast<unsigned int>(mSize); }
+    inline float getProgress() const { // Download progress [0;1] (see 'fill')
+
+        if (mStatus != STATUS_FILL)
+            return 1.f; // Done (or error)
+        int received = static_cast<int>(mWalk - mData);
+        return (received + mSize)? static_cast<float>(received) / (received + mSize):0.f;
+    };
     inline const char* getBuffer() const { return mData; }
 
     signed char fill(const ClientMgr* mgr);
@@ -127,12 +165,14 @@ public:
 
 #ifndef PAID_VERSION
     void save(const unsigned char* logo, bool landscape, unsigned char client = 0);
-    bool record(const unsigned char* logo, bool landscape, short client);
+    bool record(const unsigned char* logo, bool landscape, short client, char* rgba = NULL, bool compress = false);
 #else
     void save(bool landscape, unsigned char client = 0);
-    bool record(bool landscape, short client);
+    bool record(bool landscape, short client, char* rgba = NULL, bool compress = false);
+    // -> 'rgba': Frame buffer in RAM (instead of BIN file)
 #endif
-    bool extract(bool landscape, short frame);
+    // -> 'compress': Keep JPEG into buffer (see 'getBuffer' & 'getSize') instead of JPEG file
+    bool extract(bool landscape, short frame, unsigned char client = 0); // 'img_<frame>' or 'img_<000>' (client)
 
 };
 
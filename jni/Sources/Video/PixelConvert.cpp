@@ -0,0 +1,276 @@
+#include "PixelConvert.h"
+
+#include <cstring>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+#define CONVERT_NEON_ENABLED
+#include <arm_neon.h>
+#if defined(__ANDROID__) && defined(__arm__)
+#include <cpu-features.h> // NEON is optional on ARMv7
+#endif
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+////// Scalar
+static void swizzleScalar(unsigned char* dst, const unsigned char* src, int count) {
+
+    for (int i = 0; i < count; ++i, dst += 4, src += 4) {
+
+        unsigned char red = src[2];
+        dst[2] = src[0];
+        dst[1] = src[1];
+        dst[0] = red;
+        dst[3] = src[3];
+    }
+}
+static void toRGBScalar(unsigned char* dst, const unsigned char* src, int count, bool bgra) {
+
+    const unsigned char red = (bgra)? 2:0;
+    for (int i = 0; i < count; ++i, dst += 3, src += 4) {
+
+        dst[0] = src[red];
+        dst[1] = src[1];
+        dst[2] = src[2 - red];
+    }
+}
+static void toLAScalar(unsigned char* dst, const unsigned char* src, int count) {
+
+    for (int i = 0; i < count; ++i, dst += 2, src += 4) {
+
+        dst[0] = src[0]; // Luminance (Red == Green == Blue: 0 -> Red)
+        dst[1] = src[3]; // Alpha
+    }
+}
+static void blendScalar(unsigned char* dst, const unsigned char* premul, const unsigned char* inverse, int count) {
+
+    for (int i = 0; i < count; ++i) {
+
+        unsigned short x = (dst[i] * inverse[i]) + 128; // Rounded division by 255
+        dst[i] = premul[i] + static_cast<unsigned char>((x + (x >> 8)) >> 8);
+    }
+}
+
+#ifdef __SSE2__
+////// SSE2 (4 pixels per register)
+static inline __m128i swapRB(__m128i pixels) {
+
+    const __m128i ga = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+    const __m128i rb = _mm_set1_epi32(0x00ff00ff);
+    __m128i swap = _mm_and_si128(pixels, rb);
+    swap = _mm_and_si128(_mm_or_si128(_mm_slli_epi32(swap, 16), _mm_srli_epi32(swap, 16)), rb);
+    return _mm_or_si128(_mm_and_si128(pixels, ga), swap);
+}
+static void swizzleSSE2(unsigned char* dst, const unsigned char* src, int count) {
+
+    int i = 0;
+    for ( ; (i + 4) <= count; i += 4, dst += 16, src += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                swapRB(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+    swizzleScalar(dst, src, count - i);
+}
+static void toRGBSSE2(unsigned char* dst, const unsigned char* src, int count, bool bgra) {
+
+    const __m128i low = _mm_set_epi32(0, 0x00ffffff, 0, 0x00ffffff); // 1st pixel of each 64 bits lane
+    const __m128i high = _mm_set_epi32(0x0000ffff, static_cast<int>(0xff000000), 0x0000ffff,
+            static_cast<int>(0xff000000)); // 2nd pixel of each 64 bits lane (shifted by 1 byte)
+    int i = 0;
+    for ( ; (i + 5) <= count; i += 4, dst += 12, src += 16) { // Each store writes 2 bytes of the next pixel
+
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        if (bgra)
+            pixels = swapRB(pixels);
+
+        pixels = _mm_or_si128(_mm_and_si128(pixels, low), _mm_and_si128(_mm_srli_epi64(pixels, 8), high));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), pixels);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 6), _mm_srli_si128(pixels, 8));
+    }
+    toRGBScalar(dst, src, count - i, bgra);
+}
+static void toLASSE2(unsigned char* dst, const unsigned char* src, int count) {
+
+    const __m128i red = _mm_set1_epi32(0x000000ff);
+    const __m128i alpha = _mm_set1_epi32(0x0000ff00);
+    int i = 0;
+    for ( ; (i + 8) <= count; i += 8, dst += 16, src += 32) {
+
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        first = _mm_or_si128(_mm_and_si128(first, red), _mm_and_si128(_mm_srli_epi32(first, 16), alpha));
+        second = _mm_or_si128(_mm_and_si128(second, red), _mm_and_si128(_mm_srli_epi32(second, 16), alpha));
+
+        // Sign extend 16 bits values to avoid signed saturation
+        first = _mm_srai_epi32(_mm_slli_epi32(first, 16), 16);
+        second = _mm_srai_epi32(_mm_slli_epi32(second, 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(first, second));
+    }
+    toLAScalar(dst, src, count - i);
+}
+static void blendSSE2(unsigned char* dst, const unsigned char* premul, const unsigned char* inverse, int count) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    int i = 0;
+    for ( ; (i + 16) <= count; i += 16) {
+
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i factors = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inverse + i));
+
+        __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero),
+                _mm_unpacklo_epi8(factors, zero)), half);
+        __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero),
+                _mm_unpackhi_epi8(factors, zero)), half);
+        low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+        high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi8(_mm_packus_epi16(low, high),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(premul + i))));
+    }
+    blendScalar(dst + i, premul + i, inverse + i, count - i);
+}
+#endif
+
+#ifdef CONVERT_NEON_ENABLED
+////// NEON (16 pixels deinterleaved per load)
+static void swizzleNEON(unsigned char* dst, const unsigned char* src, int count) {
+
+    int i = 0;
+    for ( ; (i + 16) <= count; i += 16, dst += 64, src += 64) {
+
+        uint8x16x4_t pixels = vld4q_u8(src);
+        uint8x16_t red = pixels.val[2];
+        pixels.val[2] = pixels.val[0];
+        pixels.val[0] = red;
+        vst4q_u8(dst, pixels);
+    }
+    swizzleScalar(dst, src, count - i);
+}
+static void toRGBNEON(unsigned char* dst, const unsigned char* src, int count, bool bgra) {
+
+    int i = 0;
+    for ( ; (i + 16) <= count; i += 16, dst += 48, src += 64) {
+
+        uint8x16x4_t pixels = vld4q_u8(src);
+        uint8x16x3_t rgb;
+        rgb.val[0] = (bgra)? pixels.val[2]:pixels.val[0];
+        rgb.val[1] = pixels.val[1];
+        rgb.val[2] = (bgra)? pixels.val[0]:pixels.val[2];
+        vst3q_u8(dst, rgb);
+    }
+    toRGBScalar(dst, src, count - i, bgra);
+}
+static void toLANEON(unsigned char* dst, const unsigned char* src, int count) {
+
+    int i = 0;
+    for ( ; (i + 16) <= count; i += 16, dst += 32, src += 64) {
+
+        uint8x16x4_t pixels = vld4q_u8(src);
+        uint8x16x2_t la;
+        la.val[0] = pixels.val[0];
+        la.val[1] = pixels.val[3];
+        vst2q_u8(dst, la);
+    }
+    toLAScalar(dst, src, count - i);
+}
+static void blendNEON(unsigned char* dst, const unsigned char* premul, const unsigned char* inverse, int count) {
+
+    int i = 0;
+    for ( ; (i + 8) <= count; i += 8) {
+
+        uint16x8_t x = vmull_u8(vld1_u8(dst + i), vld1_u8(inverse + i));
+        vst1_u8(dst + i, vadd_u8(vrshrn_n_u16(vrsraq_n_u16(x, x, 8), 8), vld1_u8(premul + i))); // Rounded / 255
+    }
+    blendScalar(dst + i, premul + i, inverse + i, count - i);
+}
+#endif
+
+//////
+const PixelConvert::Engine* PixelConvert::mEngine = NULL;
+
+#ifdef DEBUG
+#define CONVERT_CHECK_COUNT         37 // Pixel count of the self-test (not a multiple of the vector widths: tail)
+
+void PixelConvert::check(const Engine* engine, const Engine* scalar) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - e:%p; s:%p"), __PRETTY_FUNCTION__, __LINE__, engine, scalar);
+    unsigned char src[CONVERT_CHECK_COUNT * 4];
+    unsigned char inverse[CONVERT_CHECK_COUNT * 4];
+    unsigned char premul[CONVERT_CHECK_COUNT * 4];
+    for (int i = 0; i < (CONVERT_CHECK_COUNT * 4); ++i) {
+
+        src[i] = static_cast<unsigned char>((i * 97) + 13); // Any value (including 0 & 255)
+        inverse[i] = static_cast<unsigned char>(255 - ((i * 53) & 0xff));
+        premul[i] = static_cast<unsigned char>(((255 - inverse[i]) * src[(i * 7) % (CONVERT_CHECK_COUNT * 4)]) / 255);
+    }
+    unsigned char expected[CONVERT_CHECK_COUNT * 4];
+    unsigned char result[CONVERT_CHECK_COUNT * 4];
+    bool same = true;
+
+    scalar->swizzle(expected, src, CONVERT_CHECK_COUNT);
+    engine->swizzle(result, src, CONVERT_CHECK_COUNT);
+    if (std::memcmp(expected, result, CONVERT_CHECK_COUNT * 4)) {
+        LOGE(LOG_FORMAT(" - Swizzle mismatch (path %d)"), __PRETTY_FUNCTION__, __LINE__, engine->path);
+        same = false;
+    }
+    for (unsigned char bgra = 0; bgra < 2; ++bgra) {
+
+        scalar->toRGB(expected, src, CONVERT_CHECK_COUNT, bgra != 0);
+        engine->toRGB(result, src, CONVERT_CHECK_COUNT, bgra != 0);
+        if (std::memcmp(expected, result, CONVERT_CHECK_COUNT * 3)) {
+            LOGE(LOG_FORMAT(" - RGB mismatch (path %d; bgra %d)"), __PRETTY_FUNCTION__, __LINE__, engine->path, bgra);
+            same = false;
+        }
+    }
+    scalar->toLA(expected, src, CONVERT_CHECK_COUNT);
+    engine->toLA(result, src, CONVERT_CHECK_COUNT);
+    if (std::memcmp(expected, result, CONVERT_CHECK_COUNT * 2)) {
+        LOGE(LOG_FORMAT(" - LA mismatch (path %d)"), __PRETTY_FUNCTION__, __LINE__, engine->path);
+        same = false;
+    }
+    std::memcpy(expected, src, CONVERT_CHECK_COUNT * 4);
+    std::memcpy(result, src, CONVERT_CHECK_COUNT * 4);
+    scalar->blend(expected, premul, inverse, CONVERT_CHECK_COUNT * 4);
+    engine->blend(result, premul, inverse, CONVERT_CHECK_COUNT * 4);
+    if (std::memcmp(expected, result, CONVERT_CHECK_COUNT * 4)) {
+        LOGE(LOG_FORMAT(" - Blend mismatch (path %d)"), __PRETTY_FUNCTION__, __LINE__, engine->path);
+        same = false;
+    }
+    if (!same)
+        assert(NULL); // SIMD kernels must be bit-exact with the scalar ones
+}
+#endif
+
+const PixelConvert::Engine* PixelConvert::select() {
+
+    static const Engine scalar = { CONVERT_SCALAR, swizzleScalar, toRGBScalar, toLAScalar, blendScalar };
+    const Engine* engine = &scalar;
+#ifdef __SSE2__
+    static const Engine sse2 = { CONVERT_SSE2, swizzleSSE2, toRGBSSE2, toLASSE2, blendSSE2 };
+    engine = &sse2;
+#endif
+#ifdef CONVERT_NEON_ENABLED
+    static const Engine neon = { CONVERT_NEON, swizzleNEON, toRGBNEON, toLANEON, blendNEON };
+#if defined(__ANDROID__) && defined(__arm__)
+    if ((android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM) &&
+            (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON))
+#endif
+        engine = &neon;
+#endif
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Conversion path: %d"), __PRETTY_FUNCTION__, __LINE__, engine->path);
+#ifdef DEBUG
+    if (engine != &scalar)
+        check(engine, &scalar);
+#endif
+    mEngine = engine; // Same result for any thread
+    return engine;
+}
+
+void PixelConvert::pad(char* tex, const char* rgb, short width, short height, short texWidth) {
+
+    assert(texWidth >= width);
+    const size_t row = static_cast<size_t>(width) * 3;
+    const size_t texRow = static_cast<size_t>(texWidth) * 3;
+    for (short y = 0; y < height; ++y, tex += texRow, rgb += row)
+        std::memcpy(tex, rgb, row); // Vectorized by the C library
+}
@@ -0,0 +1,64 @@
+#ifndef PIXELCONVERT_H_
+#define PIXELCONVERT_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+
+#define CONVERT_SCALAR              0
+#define CONVERT_SSE2                1
+#define CONVERT_NEON                2
+
+//////
+class PixelConvert { // Pixel format conversions with NEON/SSE2 paths selected at runtime (scalar fallback)
+
+private:
+    typedef void (*Swizzle)(unsigned char* dst, const unsigned char* src, int count);
+    typedef void (*ToRGB)(unsigned char* dst, const unsigned char* src, int count, bool bgra);
+    typedef void (*ToLA)(unsigned char* dst, const unsigned char* src, int count);
+    typedef void (*Blend)(unsigned char* dst, const unsigned char* premul, const unsigned char* inverse, int count);
+
+    typedef struct {
+
+        unsigned char path; // CONVERT_SCALAR, CONVERT_SSE2 or CONVERT_NEON
+        Swizzle swizzle;
+        ToRGB toRGB;
+        ToLA toLA;
+        Blend blend;
+
+    } Engine;
+    static const Engine* mEngine; // Selected once (first call)
+
+    static const Engine* select();
+#ifdef DEBUG
+    static void check(const Engine* engine, const Engine* scalar); // Compare 'engine' outputs with the scalar ones
+#endif
+    static inline const Engine* get() { return (mEngine)? mEngine:select(); }
+
+public:
+    static inline unsigned char getPath() { return get()->path; }
+
+    // Swap red & blue components of 'count' pixels: BGRA <-> RGBA ('dst' can be 'src')
+    static inline void swizzle(char* dst, const char* src, int count) {
+        get()->swizzle(reinterpret_cast<unsigned char*>(dst), reinterpret_cast<const unsigned char*>(src), count);
+    };
+    // Drop alpha component of 'count' RGBA (or BGRA) pixels into RGB
+    static inline void toRGB(char* dst, const char* src, int count, bool bgra = false) {
+        get()->toRGB(reinterpret_cast<unsigned char*>(dst), reinterpret_cast<const unsigned char*>(src), count, bgra);
+    };
+    // Keep red (luminance) & alpha components of 'count' grayscale RGBA pixels into LA
+    static inline void toLA(char* dst, const char* src, int count) {
+        get()->toLA(reinterpret_cast<unsigned char*>(dst), reinterpret_cast<const unsigned char*>(src), count);
+    };
+
+    // Blend 'count' premultiplied bytes over 'dst' (8 bits fixed-point): dst = premul + (dst * inverse) / 255
+    static inline void blend(char* dst, const unsigned char* premul, const unsigned char* inverse, int count) {
+        get()->blend(reinterpret_cast<unsigned char*>(dst), premul, inverse, count);
+    };
+
+    // Copy RGB rows into a texture buffer with 'texWidth' texels per row (padding unchanged)
+    static void pad(char* tex, const char* rgb, short width, short height, short texWidth);
+
+};
+
+#endif // PIXELCONVERT_H_
@@ -0,0 +1,117 @@
+#ifndef PIXELKERNEL_H_
+#define PIXELKERNEL_H_
+
+#include "Global.h"
+
+#include <libeng/Log/Log.h>
+#include <algorithm>
+
+#ifdef __ANDROID__
+#include "Video/PixelConvert.h"
+#else
+#include "PixelConvert.h"
+#endif
+
+#define ROTATE_TILE                 16 // Block size (in pixel) of the rotations: Source & destination rows in cache
+
+//////
+class PixelKernel { // Pixel loops instantiated per supported resolution (constant loop bounds & strides)
+
+private:
+    // Resolution 0x0: Any resolution (runtime width & height)
+    template<short W, short H, unsigned char P>
+    static inline void rotate(char* dst, const char* src, short width, short height, bool land2port) {
+
+        const short camWidth = (W)? W:width;
+        const short camHeight = (H)? H:height;
+        for (short xTile = 0; xTile < camWidth; xTile += ROTATE_TILE) {
+
+            const short xEnd = std::min<short>(xTile + ROTATE_TILE, camWidth);
+            for (short yTile = 0; yTile < camHeight; yTile += ROTATE_TILE) {
+
+                const short yEnd = std::min<short>(yTile + ROTATE_TILE, camHeight);
+                for (short xPort = xTile, xLand = xTile; xPort < xEnd; ++xPort, ++xLand) {
+                    for (short yPort = yTile, yLand = (camHeight - 1 - yTile); yPort < yEnd; ++yPort, --yLand) {
+
+                        int iPort = ((xPort * camHeight) + yPort) * P;
+                        int iLand = ((yLand * camWidth) + xLand) * P;
+
+                        if (!land2port) // From portrait to landscape
+                            std::swap<int>(iPort, iLand);
+                        //else // From landscape to portrait
+
+                        for (unsigned char p = 0; p < P; ++p) // All components (unrolled)
+                            dst[iPort + p] = src[iLand + p];
+                    }
+                }
+            }
+        }
+    };
+    template<bool LAND, bool BGRA>
+    static inline void record(char* rgb, const char* src, short width, short height) {
+
+        const short dstWidth = (LAND)? width:height;
+        const short dstHeight = (LAND)? height:width;
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+        if (LAND) { // Contiguous frame: Vectorized conversion
+
+            PixelConvert::toRGB(rgb, src, width * height, BGRA);
+            return;
+        }
+        // Portrait: Destination row 'y' is the source column 'y' read from the bottom (tiled)
+        for (short yTile = 0; yTile < dstHeight; yTile += ROTATE_TILE) {
+
+            const short yEnd = std::min<short>(yTile + ROTATE_TILE, dstHeight);
+            for (short xTile = 0; xTile < dstWidth; xTile += ROTATE_TILE) {
+
+                const short xEnd = std::min<short>(xTile + ROTATE_TILE, dstWidth);
+                for (short y = yTile; y < yEnd; ++y) {
+
+                    unsigned char* out = reinterpret_cast<unsigned char*>(rgb) + (((y * dstWidth) + xTile) * 3);
+                    for (short x = xTile; x < xEnd; ++x, out += 3) {
+
+                        const unsigned char* pix = in + ((((height - 1 - x) * width) + y) * 4);
+                        out[0] = pix[(BGRA)? 2:0];
+                        out[1] = pix[1];
+                        out[2] = pix[(BGRA)? 0:2];
+                    }
+                }
+            }
+        }
+    };
+
+public:
+    // Rotate landscape 'width' x 'height' RGB buffer to portrait (or portrait to landscape if not 'land2port')
+    // out-of-place
+    static inline void rotate(char* dst, const char* src, short width, short height, bool land2port) {
+
+        if ((width == CAM_WIDTH) && (height == CAM_HEIGHT))
+            rotate<CAM_WIDTH, CAM_HEIGHT, 3>(dst, src, width, height, land2port);
+        else if ((width == CAM_HD_WIDTH) && (height == CAM_HD_HEIGHT))
+            rotate<CAM_HD_WIDTH, CAM_HD_HEIGHT, 3>(dst, src, width, height, land2port);
+        else if ((width == (CAM_HD_WIDTH >> 1)) && (height == (CAM_HD_HEIGHT >> 1))) // HD preview
+            rotate<(CAM_HD_WIDTH >> 1), (CAM_HD_HEIGHT >> 1), 3>(dst, src, width, height, land2port);
+        else
+            rotate<0, 0, 3>(dst, src, width, height, land2port);
+    };
+
+    // Single pass from landscape 'width' x 'height' camera frame (RGBA or BGRA) to encoder input (RGB): Swizzle &
+    // rotation to portrait (if not 'landscape')
+    static inline void record(char* rgb, const char* src, short width, short height, bool landscape, bool bgra) {
+
+        if (landscape) {
+
+            if (bgra)
+                record<true, true>(rgb, src, width, height);
+            else
+                record<true, false>(rgb, src, width, height);
+        }
+        else if (bgra)
+            record<false, true>(rgb, src, width, height);
+        else
+            record<false, false>(rgb, src, width, height);
+    };
+
+};
+
+#endif // PIXELKERNEL_H_
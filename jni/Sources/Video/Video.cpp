@@ -3,18 +3,23 @@
 #include <libeng/Storage/Storage.h>
 #include <libeng/Player/Player.h>
 #include <stdio.h>
+#include <unistd.h>
 #include <time.h>
 #include <iostream>
 #include <fstream>
 
 #ifdef __ANDROID__
 #include <boost/filesystem.hpp>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
 #include "Wifi/Connexion.h"
 #include "Share/Share.h"
+#include "Video/BufferPool.h"
 
 #else
 #include "Connexion.h"
 #include "Share.h"
+#include "BufferPool.h"
 
 #endif
 
@@ -34,9 +39,14 @@
 #endif
 #define SAVE_VIDEO_ERROR            "ERROR: Failed to create video! Please to retry."
 
-#define REC_AFTER_IDX               700 // > (255 frame * 2) + (7 * 9)
+#define REC_AFTER_IDX               (RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER + \
+                                    (255 * 2 * MCAM_FPS_FACTOR(MAX_VIDEO_FPS))) // > B4 frames + lag + bullet time frames
+#define REC_BENCH_IDX               (REC_AFTER_IDX + RECORD_FRAMES_AFTER) // Self-benchmark frame index (> any frame index)
 
 #define MCAM_MIC_FILENAME           "/MCAMmicFile"
+#ifndef __ANDROID__
+#define SEQ_FILE_NAME               "/seq_" // Timeline frames linked for 'multifilesrc' (see 'PROC_SAVE')
+#endif
 #define WAV_HEADER_SIZE             44
 #ifdef __ANDROID__
 #define BYTES_PER_SECOND            88200.f // = SampleRate * Channels * BitsPerSample / 8 = 44100 * 1 * 16 / 8
@@ -53,14 +63,37 @@
 
 #define SOUND_ID_FILM               (SOUND_ID_LOGO + 1)
 
+#ifdef __ANDROID__
+#define VIDEO_FRAMES_SRC            "appsrc name=frames format=time block=true caps=\"image/jpeg,framerate=0/1\""
+#define VIDEO_AUDIO_QUEUE           "queue max-size-buffers=0 max-size-bytes=0 max-size-time=0" // Never blocks the tee
+#define VIDEO_WEBM_AUDIO            "vorbisenc"
+#define VIDEO_MOV_CAPS              "video/x-h264,profile=baseline"
+#define VIDEO_MOV_AUDIO             "voaacenc"
+#endif
+
 //////
-Recorder::Recorder(const std::string* folder) : mLandscape(true), mFolder(folder), mAbort(true), mThread(NULL) {
+Recorder::Recorder(const std::string* folder) : mLandscape(true), mFolder(folder), mAbort(true), mQueueFull(0),
+        mRingMiss(0), mSequence(0), mRing(CAM_WIDTH * CAM_HEIGHT * 4), mSpill(SPILL_FULL), mSpool(false),
+        mCompress(false), mContinuous(false), mHead(0), mEvicted(0),
+        mStart(0), mPendingCount(0), mGO(0), mConvTime(0), mDeadline(0), mRecording(false), mWorkers(0),
+        mRate(DEF_VIDEO_FPS) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%x (%s)"), __PRETTY_FUNCTION__, __LINE__, folder,
             (folder)? folder->c_str():"null");
 #ifndef PAID_VERSION
     mLogo = NULL;
 #endif
+    for (short i = 0; i < (RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER); ++i) {
+
+        mFrames[i].jpeg = NULL;
+        mFrames[i].jpegSize = 0;
+        mFrames[i].jpegCapacity = 0;
+    }
+    for (unsigned char i = 0; i < CamFrame::RES_COUNT; ++i)
+        mBenchTime[i] = 0;
+    mBefore.reserve(RECORD_FRAMES_BEFORE);
+    mAfter.reserve(RECORD_FRAMES_AFTER);
+    mQueue.resize(RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER);
 }
 Recorder::~Recorder() {
 
@@ -68,141 +101,532 @@ Recorder::~Recorder() {
     clear();
 }
 
-time_t Recorder::add(const unsigned char* rgba, bool before) {
+unsigned char Recorder::getWorkers() {
+
+    unsigned char count = static_cast<unsigned char>(boost::thread::hardware_concurrency());
+    if (!count)
+        return 1; // Unknown core count
+
+    return (count > RECORD_MAX_WORKER)? RECORD_MAX_WORKER:count;
+}
+#ifndef PAID_VERSION
+bool Recorder::arm(unsigned char fps, const unsigned char* logo) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%d; l:%x (r:%d)"), __PRETTY_FUNCTION__, __LINE__, fps, logo,
+            CamFrame::getSession());
+#else
+bool Recorder::arm(unsigned char fps) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%d (r:%d)"), __PRETTY_FUNCTION__, __LINE__, fps, CamFrame::getSession());
+#endif
+    assert(mThreads.empty());
+    assert((fps >= MIN_VIDEO_FPS) && (fps <= MAX_VIDEO_FPS));
+#ifndef PAID_VERSION
+    mLogo = logo;
+    Picture::prepareLogo(logo); // Before any conversion (self-benchmark & workers started by 'reserve')
+#endif
+
+    mRate = DEF_VIDEO_FPS;
+    if (fps <= DEF_VIDEO_FPS) {
+
+        mRate = fps;
+        return true; // No need to check it
+    }
+    unsigned int &benchTime = mBenchTime[CamFrame::getSession()]; // Benchmark frame: See 'CamFrame::getSize'
+    if (!benchTime) { // Self-benchmark (once per resolution)
+
+        char* rgba;
+        try { rgba = BufferPool::get(static_cast<size_t>(CamFrame::getSize(4))); }
+        catch (const std::bad_alloc &e) {
+
+            LOGW(LOG_FORMAT(" - Failed to allocate benchmark frame"), __PRETTY_FUNCTION__, __LINE__);
+            return false;
+        }
+        for (int i = 0; i < CamFrame::getSize(4); ++i)
+            rgba[i] = static_cast<char>((i * 7) + (i >> 11)); // Not uniform (JPEG encoding time)
+
+        Picture::createPath(mFolder);
+        unsigned int begin = CamFrame::now();
+        unsigned int encode = 0;
+        bool done = true;
+        for (unsigned char i = 0; (done) && (i < RECORD_BENCH_FRAMES); ++i) {
+
+            Picture picture(mFolder);
+#ifdef __ANDROID__
+            picture.setCodec(&mCodecs[0]);
+#endif
+#ifndef PAID_VERSION
+            done = picture.record(logo, true, REC_BENCH_IDX, rgba, true);
+#else
+            done = picture.record(true, REC_BENCH_IDX, rgba, true);
+#endif
+            encode += picture.getEncodeTime();
+        }
+        BufferPool::release(rgba);
+        if (!done) {
+
+            LOGW(LOG_FORMAT(" - Self-benchmark failed"), __PRETTY_FUNCTION__, __LINE__);
+            return false;
+        }
+        benchTime = (CamFrame::now() - begin) / RECORD_BENCH_FRAMES;
+        if (!benchTime)
+            benchTime = 1;
+        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Self-benchmark: %u ms/frame (JPEG encoding: %u ms/frame)"),
+                __PRETTY_FUNCTION__, __LINE__, benchTime, encode / RECORD_BENCH_FRAMES);
+    }
+
+    // Conversion should keep up with the capture (a core is kept for the capture thread)
+    unsigned char workers = getWorkers();
+    if (workers > 1)
+        --workers;
+    unsigned int sustained = (1000 * workers) / benchTime; // Frame per second
+    if (sustained < fps) {
+
+        LOGW(LOG_FORMAT(" - %d fps refused: %u fps sustained (%u ms per frame; %d worker(s))"), __PRETTY_FUNCTION__,
+                __LINE__, fps, sustained, benchTime, workers);
+        return false;
+    }
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %d fps armed (%u fps sustained)"), __PRETTY_FUNCTION__, __LINE__, fps,
+            sustained);
+    mRate = fps;
+    return true;
+}
+
+void Recorder::reserve() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (s:%d; c:%s)"), __PRETTY_FUNCTION__, __LINE__, mSpill,
+            (mCompress)? "true":"false");
+    if (mSpill == SPILL_ALWAYS)
+        return; // No slot needed
+
+    mRing.setSlotSize(static_cast<size_t>(CamFrame::getSize(4))); // Session resolution
 
-    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - r:%x; b:%s (b:%d; a:%d)"), __PRETTY_FUNCTION__, __LINE__, rgba,
-            (before)? "true":"false", static_cast<short>(mBefore.size()), static_cast<short>(mAfter.size()));
+    // Compressed mode: Slots are only needed until each frame is compressed
+    short count = (mCompress)? (RECORD_COMPRESS_DELAY * mRate):(getMaxBefore() + getMaxAfter());
+    if (mSpool) {
+
+        std::string fileName(*mFolder);
+        fileName.append(MCAM_SUB_FOLDER);
+        fileName.append(RECORD_SPOOL_FILENAME);
+
+        // Check free space according the session resolution & capture frame rate
+        float size = static_cast<float>(RING_SPOOL_HEADER) + (count * static_cast<float>(RING_SPOOL_STRIDE(
+                mRing.getSlotSize())));
+        float space = Storage::getFreeSpace(*mFolder);
+        short slots = 0;
+        if (space < (size + RECORD_SPOOL_FREE))
+            LOGW(LOG_FORMAT(" - Free space unsufficient for spool: %f < %f + %d"), __PRETTY_FUNCTION__, __LINE__, space,
+                    size, RECORD_SPOOL_FREE);
+        else
+            slots = mRing.map(fileName, count);
+        if (slots) {
+
+            LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %d spool slot(s) available"), __PRETTY_FUNCTION__, __LINE__, slots);
+            return;
+        }
+        LOGW(LOG_FORMAT(" - Failed to create spool: Use RAM"), __PRETTY_FUNCTION__, __LINE__);
+    }
+    short slots = static_cast<short>(RING_MAX_MEMORY / mRing.getSlotSize());
+    if (slots > count)
+        slots = count;
+
+    slots = mRing.allocate(slots);
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %d slot(s) available"), __PRETTY_FUNCTION__, __LINE__, slots);
+}
+void Recorder::prepare(bool landscape) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - l:%s"), __PRETTY_FUNCTION__, __LINE__, (landscape)? "true":"false");
+    assert(mThreads.empty());
+#ifdef __ANDROID__
+    unsigned int begin = CamFrame::now();
+    unsigned char count = getWorkers();
+    for (unsigned char i = 0; i < count; ++i)
+        mCodecs[i].open(FrameCodec::CODEC_ENCODE, (landscape)? CamFrame::getWidth():CamFrame::getHeight(),
+                (landscape)? CamFrame::getHeight():CamFrame::getWidth(), Picture::getQuality());
+
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %d encoder session(s) opened in %u ms"), __PRETTY_FUNCTION__, __LINE__,
+            count, CamFrame::now() - begin);
+#endif
+}
+unsigned int Recorder::add(const unsigned char* rgba, bool before, unsigned int stamp) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - r:%x; b:%s; s:%u (b:%d; a:%d)"), __PRETTY_FUNCTION__, __LINE__, rgba,
+            (before)? "true":"false", stamp, static_cast<short>(mBefore.size()), static_cast<short>(mAfter.size()));
     assert(rgba);
 
+    unsigned int sequence = CamFrame::getSequence();
+    if ((sequence) && (sequence == mSequence)) {
+
+        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Camera frame #%u already added"), __PRETTY_FUNCTION__, __LINE__,
+                sequence);
+        return stamp; // Same capture time: Would be a frame without duration
+    }
+    bool evict = (before) && (mContinuous) && (static_cast<short>(mBefore.size()) == getMaxBefore());
+    if ((!evict) && (((before) && (static_cast<short>(mBefore.size()) == getMaxBefore())) ||
+            ((!before) && (static_cast<short>(mAfter.size()) == getMaxAfter()))))
+        return 0; // Full
+
     RecFrame* frame;
-    try { frame = new RecFrame; }
-    catch (std::bad_alloc e) {
+    bool requeue = false;
+    if (evict) { // Replace the oldest frame (keep its index & slot)
+
+        frame = mBefore[mHead];
+        if (!mAbort) { // Conversion threads running (compressed mode)
+
+            if (frame->status == STATUS_PROGRESS) {
 
-        LOGE(LOG_FORMAT(" - Avoid heap memory corruption (lock/unlock screen operation)"), __PRETTY_FUNCTION__, __LINE__);
-        return 0;
+                LOGW(LOG_FORMAT(" - Oldest frame %d not compressed yet: Frame dropped"), __PRETTY_FUNCTION__, __LINE__,
+                        frame->index);
+                return stamp;
+            }
+            __sync_synchronize(); // Status read B4 slot (see 'processThreadRunning')
+            requeue = true; // Already converted (its slot has been released)
+        }
     }
-    frame->elapsed = time(NULL);
-    frame->status = STATUS_PROGRESS;
-    frame->index = (before)? static_cast<short>(mBefore.size()):static_cast<short>(mAfter.size() + REC_AFTER_IDX);
+    else {
 
-    std::string fileName(*mFolder);
-    fileName.append(MCAM_SUB_FOLDER);
-    fileName.append(PIC_FILE_NAME);
-    fileName.append(numToStr<short>(static_cast<short>(frame->index)));
-    fileName.append(BIN_FILE_EXTENSION);
+        frame = &mFrames[mBefore.size() + mAfter.size()];
+        frame->index = (before)? static_cast<short>(mBefore.size()):static_cast<short>(mAfter.size() + REC_AFTER_IDX);
+        frame->slot = RING_NO_SLOT;
+    }
+    if (!mStart)
+        mStart = stamp;
+    mSequence = sequence;
 
-    // Save BIN file now!
-    FILE* file = fopen(fileName.c_str(), "wb");
-    if (!file) {
+    // Keep frame in RAM (if possible)
+    if ((frame->slot == RING_NO_SLOT) && (mSpill != SPILL_ALWAYS))
+        frame->slot = mRing.acquire();
+    if (frame->slot == RING_NO_SLOT)
+        ++mRingMiss;
 
-        LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
-        assert(NULL);
-        delete frame;
-        return 0;
+    if (frame->slot != RING_NO_SLOT) {
+
+        std::memcpy(mRing.get(frame->slot), rgba, CamFrame::getSize(4));
+        mRing.setFrame(frame->slot, frame->index);
     }
-    if (fwrite(rgba, sizeof(char), (CAM_HEIGHT * CAM_WIDTH * 4), file) != (CAM_HEIGHT * CAM_WIDTH * 4)) {
 
-        LOGE(LOG_FORMAT(" - Failed to write %d bytes into file %s"), __PRETTY_FUNCTION__, __LINE__, (CAM_HEIGHT *
-                CAM_WIDTH * 4), fileName.c_str());
-        assert(NULL);
+    else if (mSpill == SPILL_NONE) {
+
+        LOGW(LOG_FORMAT(" - No more free slot: Frame dropped"), __PRETTY_FUNCTION__, __LINE__);
+        return stamp;
+    }
+    else { // Spill into BIN file
+
+        FramePath path(mFolder);
+        const char* fileName = path.get(static_cast<short>(frame->index), BIN_FILE_EXTENSION);
+
+        FILE* file = fopen(fileName, "wb");
+        if (!file) {
+
+            LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
+            assert(NULL);
+            return 0;
+        }
+        size_t size = static_cast<size_t>(CamFrame::getSize(4));
+        if (fwrite(rgba, sizeof(char), size, file) != size) {
+
+            LOGE(LOG_FORMAT(" - Failed to write %d bytes into file %s"), __PRETTY_FUNCTION__, __LINE__, size,
+                    fileName);
+            assert(NULL);
+            fclose(file);
+            return 0;
+        }
         fclose(file);
-        delete frame;
-        return 0;
     }
-    fclose(file);
 
-    mMutex.lock();
-    (before)? mBefore.push_back(frame):mAfter.push_back(frame);
-    mMutex.unlock();
+    frame->stamp = stamp;
+    frame->status = STATUS_PROGRESS;
+
+    // No lock: The capture thread never waits the conversion threads
+    if (evict) {
 
-    return ((before) && (mBefore.size() == (RECORD_DURATION_BEFORE * MAX_VIDEO_FPS))) ||
-            ((!before) && (mAfter.size() == (RECORD_DURATION_AFTER * MAX_VIDEO_FPS)))? 0:frame->elapsed;
+        mHead = (mHead + 1) % getMaxBefore();
+        ++mEvicted;
+        // -> An evicted frame is already queued if not converted yet (B4 'start')
+    }
+    if (requeue) {
+
+        if (!mQueue.push(frame)) {
+
+            LOGW(LOG_FORMAT(" - Frame %d not queued"), __PRETTY_FUNCTION__, __LINE__, frame->index);
+            ++mQueueFull;
+            frame->status = STATUS_ERROR;
+        }
+        mCondition.notify_one();
+    }
+    else {
+
+        (before)? mBefore.push_back(frame):mAfter.push_back(frame);
+        if (!mQueue.push(frame)) {
+
+            LOGW(LOG_FORMAT(" - Frame %d not queued"), __PRETTY_FUNCTION__, __LINE__, frame->index);
+            ++mQueueFull;
+            frame->status = STATUS_ERROR;
+        }
+        mCondition.notify_one();
+    }
+
+    if ((before) && (mContinuous))
+        return stamp; // Never full
+    return ((before) && (static_cast<short>(mBefore.size()) == getMaxBefore())) ||
+            ((!before) && (static_cast<short>(mAfter.size()) == getMaxAfter()))? 0:stamp;
 }
 #ifndef PAID_VERSION
 void Recorder::start(const unsigned char* logo, bool landscape) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - l:%x; l:%s"), __PRETTY_FUNCTION__, __LINE__, logo, (landscape)? "true":"false");
     mLogo = logo;
+    Picture::prepareLogo(logo); // Not from the worker threads (see 'Picture::pack')
 #else
 void Recorder::start(bool landscape) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - l:%s"), __PRETTY_FUNCTION__, __LINE__, (landscape)? "true":"false");
 #endif
     mLandscape = landscape;
+    if (!mThreads.empty()) { // Compressed mode: Already converting since 'reserve'
 
-    assert(!mThread);
+        assert(mCompress);
+        mMutex.lock();
+        mGO = (mBefore.empty())? CamFrame::now():getBefore(static_cast<short>(mBefore.size()) - 1)->stamp;
+        mMutex.unlock();
+
+        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - GO (depth:%d/%d; full:%d; miss:%d)"), __PRETTY_FUNCTION__, __LINE__,
+                mQueue.getDepth(), mQueue.getMaxDepth(), mQueueFull, mRingMiss);
+        return;
+    }
     mAbort = false;
-    mThread = new boost::thread(Recorder::startProcessThread, this);
+    mRecording = true;
+    mGO = (mBefore.empty())? CamFrame::now():getBefore(static_cast<short>(mBefore.size()) - 1)->stamp;
+
+    unsigned char count = getWorkers();
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Start %d conversion thread(s) (depth:%d/%d; full:%d; miss:%d)"),
+            __PRETTY_FUNCTION__, __LINE__, count, mQueue.getDepth(), mQueue.getMaxDepth(), mQueueFull, mRingMiss);
+    mWorkers = count;
+    for (unsigned char i = 0; i < count; ++i)
+        mThreads.push_back(new boost::thread(Recorder::startProcessThread, this, i));
+}
+void Recorder::setProgress(float download) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - d:%f (g:%u)"), __PRETTY_FUNCTION__, __LINE__, download, mGO);
+    if ((!mGO) || (download < 0.01f))
+        return; // Not started or too early to estimate it
+
+    unsigned int now = CamFrame::now();
+    mDeadline = mGO + static_cast<unsigned int>((now - mGO) / ((download > 1.f)? 1.f:download));
 }
 void Recorder::clear() {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
-    if (mThread) {
+    mMutex.lock();
+    mAbort = true;
+    mMutex.unlock();
+    mCondition.notify_all();
 
-        mAbort = true;
-        mThread->join();
-        delete mThread;
+    for (std::vector<boost::thread*>::iterator iter = mThreads.begin(); iter != mThreads.end(); ++iter) {
 
-        mThread = NULL;
-    }
-    for (std::vector<RecFrame*>::iterator iter = mBefore.begin(); iter != mBefore.end(); ++iter)
+        (*iter)->join();
         delete (*iter);
+    }
+    mThreads.clear();
+#ifdef __ANDROID__
+    for (unsigned char i = 0; i < RECORD_MAX_WORKER; ++i)
+        mCodecs[i].close(); // Sessions opened per take
+#endif
+
+    for (short i = 0; i < (RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER); ++i) {
+        if (mFrames[i].jpeg) {
+
+            BufferPool::release(mFrames[i].jpeg);
+            mFrames[i].jpeg = NULL;
+            mFrames[i].jpegSize = 0;
+            mFrames[i].jpegCapacity = 0;
+        }
+    }
     mBefore.clear();
-    for (std::vector<RecFrame*>::iterator iter = mAfter.begin(); iter != mAfter.end(); ++iter)
-        delete (*iter);
     mAfter.clear();
+    mRing.free();
+
+    mHead = 0;
+    mEvicted = 0;
+    mStart = 0;
+    mQueue.reset();
+
+    mPendingCount = 0;
+    mGO = 0;
+    mConvTime = 0;
+    mDeadline = 0;
+    mRecording = false;
+    mWorkers = 0;
+    mQueueFull = 0;
+    mRingMiss = 0;
+    mSequence = 0;
 }
 
-void Recorder::processThreadRunning() {
+Recorder::RecFrame* Recorder::schedule(unsigned char worker) {
 
-    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Begin"), __PRETTY_FUNCTION__, __LINE__);
-    while (!mAbort) {
+    RecFrame* frame;
+    while (mQueue.pop(frame))
+        mPending[mPendingCount++] = frame;
+    if (!mPendingCount)
+        return NULL;
+
+    // Keep a core for the capture thread until the deadline is at risk
+    unsigned char allowed = mWorkers;
+    if ((mRecording) && (mWorkers > 1)) {
+
+        allowed = mWorkers - 1;
+        if ((mDeadline) && (mConvTime) &&
+                ((CamFrame::now() + ((mPendingCount * mConvTime) / allowed)) > mDeadline))
+            allowed = mWorkers; // Late
+    }
+    if (worker >= allowed)
+        return NULL;
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(20));
-        mMutex.lock();
-        unsigned char idx = 0;
-        for ( ; idx < static_cast<unsigned char>(mBefore.size()); ++idx)
-            if (!mBefore[idx]->status) // STATUS_PROGRESS
-                break;
+    // Nearest frame from GO first (B4 frames & bullet time lag frames are needed first)
+    short next = 0;
+    unsigned int distance = 0xffffffff;
+    for (short i = 0; i < mPendingCount; ++i) {
 
-        RecFrame* frame = NULL;
-        if (idx == static_cast<unsigned char>(mBefore.size())) {
-            idx = 0;
-            for ( ; idx < static_cast<unsigned char>(mAfter.size()); ++idx)
-                if (!mAfter[idx]->status)
-                    break;
+        unsigned int gap = (mPending[i]->stamp > mGO)? mPending[i]->stamp - mGO:mGO - mPending[i]->stamp;
+        if (gap < distance) {
+
+            distance = gap;
+            next = i;
+        }
+    }
+    frame = mPending[next];
+    mPending[next] = mPending[--mPendingCount];
+    return frame;
+}
+void Recorder::processThreadRunning(unsigned char worker) {
 
-            if (idx == static_cast<unsigned char>(mAfter.size())) {
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Begin (w:%d)"), __PRETTY_FUNCTION__, __LINE__, worker);
+    boost::unique_lock<boost::mutex> lock(mMutex, boost::defer_lock);
+    RecFrame* frame = NULL;
+    unsigned char status = STATUS_PROGRESS;
+    unsigned int begin = 0;
+    while (true) {
 
-                mMutex.unlock();
-                continue; // Nothing to do
+        lock.lock();
+        if (frame) { // Previous frame converted
+
+            if (frame->slot != RING_NO_SLOT) {
+
+                mRing.release(frame->slot);
+                frame->slot = RING_NO_SLOT;
             }
-            frame = mAfter[idx];
+            unsigned int duration = CamFrame::now() - begin;
+            mConvTime = (mConvTime)? ((mConvTime * 3) + duration) >> 2:duration;
+
+            __sync_synchronize(); // Slot released B4 status update (the frame can be evicted - see 'add')
+            frame->status = status;
         }
-        else
-            frame = mBefore[idx];
-        mMutex.unlock();
 
-        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Process file %d"), __PRETTY_FUNCTION__, __LINE__, frame->index);
+        // Timed wait: The capture thread signals without lock (signal can be missed)
+        while ((!mAbort) && (!(frame = schedule(worker))))
+            mCondition.timed_wait(lock, boost::posix_time::milliseconds(RECORD_WAKEUP_DELAY)); // Wait frame to convert
+
+        if (mAbort) {
+
+            lock.unlock();
+            break;
+        }
+        lock.unlock();
+
+        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Process file %d (slot:%d; w:%d)"), __PRETTY_FUNCTION__, __LINE__,
+                frame->index, frame->slot, worker);
+        begin = CamFrame::now();
+        char* rgba = (frame->slot != RING_NO_SLOT)? mRing.get(frame->slot):NULL;
         Picture picture(mFolder);
+#ifdef __ANDROID__
+        picture.setCodec(&mCodecs[worker]);
+#endif
 #ifndef PAID_VERSION
-        frame->status = (picture.record(mLogo, mLandscape, frame->index))? STATUS_DONE:STATUS_ERROR;
+        bool done = picture.record(mLogo, mLandscape, frame->index, rgba, mCompress);
 #else
-        frame->status = (picture.record(mLandscape, frame->index))? STATUS_DONE:STATUS_ERROR;
+        bool done = picture.record(mLandscape, frame->index, rgba, mCompress);
 #endif
+        if ((done) && (mCompress)) { // Keep JPEG buffer (reuse the previous one if large enough)
+
+            int size = static_cast<int>(picture.getSize());
+            if (frame->jpegCapacity < size) {
+
+                BufferPool::release(frame->jpeg);
+                frame->jpeg = NULL;
+                frame->jpegCapacity = 0;
+
+                try { frame->jpeg = BufferPool::get(static_cast<size_t>(size)); }
+                catch (const std::bad_alloc &e) {
+
+                    LOGW(LOG_FORMAT(" - Failed to allocate JPEG buffer (%d bytes)"), __PRETTY_FUNCTION__, __LINE__, size);
+                    done = false;
+                }
+                if (done)
+                    frame->jpegCapacity = size;
+            }
+            if (done) {
+
+                std::memcpy(frame->jpeg, picture.getBuffer(), size);
+                frame->jpegSize = size;
+            }
+        }
+        status = (done)? STATUS_DONE:STATUS_ERROR;
+        // -> Frame status updated once its slot has been released (see above)
     }
     LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Finished"), __PRETTY_FUNCTION__, __LINE__);
 }
-void Recorder::startProcessThread(Recorder* recorder) {
+bool Recorder::write() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (b:%d; a:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            static_cast<short>(mBefore.size()), static_cast<short>(mAfter.size()));
+    assert(mCompress);
+    assert(isConverted());
+
+    FramePath path(mFolder);
+    unsigned int total = 0;
+    for (short i = 0; i < (RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER); ++i) {
+
+        RecFrame* frame = &mFrames[i];
+        if ((!frame->jpeg) || (frame->status != STATUS_DONE))
+            continue; // Not used, not converted or already written
+
+        const char* fileName = path.get(frame->index, JPEG_FILE_EXTENSION);
+
+        FILE* file = fopen(fileName, "wb");
+        if (!file) {
+
+            LOGE(LOG_FORMAT(" - Failed to create file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
+            return false;
+        }
+        if (fwrite(frame->jpeg, sizeof(char), frame->jpegSize, file) != static_cast<size_t>(frame->jpegSize)) {
+
+            LOGE(LOG_FORMAT(" - Failed to write %d bytes into file %s"), __PRETTY_FUNCTION__, __LINE__, frame->jpegSize,
+                    fileName);
+            fclose(file);
+            return false;
+        }
+        fclose(file);
+        total += frame->jpegSize;
+
+        BufferPool::release(frame->jpeg); // No more needed (kept warm for the next take)
+        frame->jpeg = NULL;
+        frame->jpegSize = 0;
+        frame->jpegCapacity = 0;
+    }
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %u JPEG bytes written"), __PRETTY_FUNCTION__, __LINE__, total);
+    return true;
+}
+void Recorder::startProcessThread(Recorder* recorder, unsigned char worker) {
 
-    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - r:%x"), __PRETTY_FUNCTION__, __LINE__, recorder);
-    recorder->processThreadRunning();
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - r:%x; w:%d"), __PRETTY_FUNCTION__, __LINE__, recorder, worker);
+    recorder->processThreadRunning(worker);
 }
 
 //////
 Video::Video() : mPicIdx(0), mPicCount(0), mBuffer(NULL), mBufferLen(0), mAbort(true), mThread(NULL), mStatus(0),
         mRcvLen(0), mFilm(false), mPlaying(false), mLandscape(true), mFPS(0), mTexGen(false), mClientCount(0),
-        mDelay(0) {
+        mDelay(0), mAudioSkip(0), mBulletStart(0), mBulletLength(0), mProfile(EncoderProfile::PROFILE_AUTO),
+        mEncProfile(EncoderProfile::PROFILE_BALANCED) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
 #ifdef __ANDROID__
@@ -213,11 +637,14 @@ Video::Video() : mPicIdx(0), mPicCount(0), mBuffer(NULL), mBufferLen(0), mAbort(
         boost::filesystem::create_directory(mMovFolder.c_str());
 
     miOS = false;
+    mAndroid = false;
+
+    for (unsigned char i = 0; i < FORMAT_COUNT; ++i) {
 
-    mBufferWEBM = NULL;
-    mBufferMOV = NULL;
-    mBufferLenWEBM = 0;
-    mBufferLenMOV = 0;
+        mRenditions[i].state = RENDITION_NONE;
+        mRenditions[i].buffer = NULL;
+        mRenditions[i].size = 0;
+    }
 #else
     mPicFolder.assign(Storage::getFolder(FOLDER_TYPE_DOCUMENTS));
     mMovFolder.assign(Storage::getFolder(FOLDER_TYPE_DOCUMENTS));
@@ -228,15 +655,18 @@ Video::Video() : mPicIdx(0), mPicCount(0), mBuffer(NULL), mBufferLen(0), mAbort(
                                                         withIntermediateDirectories:NO attributes:nil error:nil];
 #endif
     mRecorder = new Recorder(&mPicFolder);
-    mTexBuffer = new char[static_cast<int>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT) * 3];
+    mPreviewH = CAM_HEIGHT;
+    mTexBuffer = BufferPool::get(static_cast<size_t>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT * 3));
     std::memset(mTexBuffer, 0, static_cast<size_t>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT * 3));
 }
 Video::~Video() {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
     clear();
-    delete [] mTexBuffer;
+    BufferPool::release(mTexBuffer);
     delete mRecorder;
+    BufferPool::log();
+    BufferPool::trim();
 }
 
 void Video::initialize(const Game2D* game) {
@@ -245,9 +675,10 @@ void Video::initialize(const Game2D* game) {
     mFilm.initialize(game);
     mFilm.start(FILM_TEXTURE_IDX);
 
-    static const float texCoords[8] = { 0.f, 0.f, 0.f, CAM_HEIGHT / CAM_TEX_HEIGHT, CAM_WIDTH / CAM_TEX_WIDTH,
-            CAM_HEIGHT / CAM_TEX_HEIGHT, CAM_WIDTH / CAM_TEX_WIDTH, 0.f };
+    float texCoords[8];
+    CamFrame::getPreviewTexCoords(texCoords);
     mFilm.setTexCoords(texCoords);
+    mPreviewH = CamFrame::getPreviewHeight();
 
     short screenW = (game->getScreen()->width >> 1) * SCREEN_SCALE_RATIO; // Half
     short screenH = screenW * CAM_HEIGHT / CAM_WIDTH;
@@ -315,24 +746,26 @@ void Video::clear(bool remove) {
     if (remove) {
 
         mRecorder->clear();
+        mTimeline.clear();
         Picture::removePath(&mPicFolder);
     }
 #ifdef __ANDROID__
-    if ((mBuffer) && (mBuffer != mBufferWEBM) && (mBuffer != mBufferMOV))
-        delete [] mBuffer;
+    if ((mBuffer) && (mBuffer != mRenditions[FORMAT_WEBM].buffer) && (mBuffer != mRenditions[FORMAT_MOV].buffer))
+        BufferPool::release(mBuffer);
 
-    if (mBufferWEBM) {
-        delete [] mBufferWEBM;
-        mBufferWEBM = NULL;
-    }
-    if (mBufferMOV) {
-        delete [] mBufferMOV;
-        mBufferMOV = NULL;
+    mRenditionMutex.lock();
+    for (unsigned char i = 0; i < FORMAT_COUNT; ++i) {
+
+        BufferPool::release(mRenditions[i].buffer);
+        mRenditions[i].state = RENDITION_NONE;
+        mRenditions[i].buffer = NULL;
+        mRenditions[i].size = 0;
     }
+    mRenditionMutex.unlock();
     mBuffer = NULL;
 #else
     if (mBuffer) {
-        delete [] mBuffer;
+        BufferPool::release(mBuffer);
         mBuffer = NULL;
     }
 #endif
@@ -397,19 +830,26 @@ bool Video::generate() {
         textures->delTexture(FILM_TEXTURE_IDX);
         textures->rmvTextures(1);
     }
-    std::string binFile(mPicFolder);
-    binFile.append(MCAM_SUB_FOLDER);
-    binFile.append(PIC_FILE_NAME);
-    binFile.append(numToStr<short>(mPicIdx));
-    binFile.append(BIN_FILE_EXTENSION);
+    FramePath path(&mPicFolder);
+    const char* binFile = mTimeline.getPath(&path, mPicIdx, BIN_FILE_EXTENSION);
 
-    std::ifstream ifs(binFile.c_str(), std::ifstream::binary);
+    std::ifstream ifs(binFile, std::ifstream::binary);
     if (!ifs.is_open()) {
 
-        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, binFile.c_str());
+        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, binFile);
         assert(NULL);
         return false;
     }
+    if (mPreviewH != CamFrame::getPreviewHeight()) { // Session resolution changed
+
+        LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Preview height changed (%d -> %d)"), __PRETTY_FUNCTION__, __LINE__,
+                mPreviewH, CamFrame::getPreviewHeight());
+        mPreviewH = CamFrame::getPreviewHeight();
+
+        float texCoords[8];
+        CamFrame::getPreviewTexCoords(texCoords);
+        mFilm.setTexCoords(texCoords);
+    }
     ifs.rdbuf()->sgetn(mTexBuffer, static_cast<size_t>(CAM_TEX_WIDTH * CAM_TEX_HEIGHT * 3));
     ifs.close();
 
@@ -434,15 +874,17 @@ void Video::mergeWAV() {
     int fileSize = static_cast<int>(wavFile.tellg());
     wavFile.seekg(0, std::ifstream::beg);
 
-    int start = static_cast<int>(mRecorder->getDoneCount(true) * BYTES_PER_SECOND / mFPS) +
-            static_cast<int>((BULLET_TIME_LAG / 1000.f) * BYTES_PER_SECOND) + WAV_HEADER_SIZE;
-    while (start % BYTES_PER_BLOC) --start; // Must be in bloc byte count
+    int skip = static_cast<int>((mAudioSkip / 1000.f) * BYTES_PER_SECOND); // B4 first frame (evicted frames)
+    while (skip % BYTES_PER_BLOC) --skip; // Must be in bloc byte count
 
-    int duration = static_cast<int>(((mClientCount + 2) * MCAM_FPS_FACTOR(mFPS)) * BYTES_PER_SECOND / mFPS);
+    int start = static_cast<int>((mBulletStart / 1000.f) * BYTES_PER_SECOND) + WAV_HEADER_SIZE + skip;
+    while (start % BYTES_PER_BLOC) --start; // ...
+
+    int duration = static_cast<int>((mBulletLength / 1000.f) * BYTES_PER_SECOND);
     while (duration % BYTES_PER_BLOC) --duration; // ...
 
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Start:%d Duration:%d (size:%d)"), __PRETTY_FUNCTION__, __LINE__, start,
-            duration, fileSize);
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Start:%d Duration:%d Skip:%d (size:%d)"), __PRETTY_FUNCTION__, __LINE__,
+            start, duration, skip, fileSize);
 
     fileName.assign(mPicFolder);
     fileName.append(MCAM_SUB_FOLDER);
@@ -463,7 +905,8 @@ void Video::mergeWAV() {
         }
         char readChar;
         wavFile.get(readChar);
-        resFile << readChar;
+        if ((i < WAV_HEADER_SIZE) || (i >= (WAV_HEADER_SIZE + skip)))
+            resFile << readChar; // Not an evicted frame audio
     }
     wavFile.close();
 
@@ -547,7 +990,7 @@ void Video::prepare(int size, unsigned char fps) {
     mFPS = fps;
 
     mBufferLen = size;
-    mBuffer = new char[size];
+    mBuffer = BufferPool::get(static_cast<size_t>(size));
     mRcvLen = 0;
 }
 signed char Video::fill(const ClientMgr* mgr) {
@@ -660,6 +1103,242 @@ bool Video::store(bool landscape) {
     return true;
 }
 
+#ifdef __ANDROID__
+std::string Video::getPath(unsigned char format) const {
+
+    std::string path(mMovFolder);
+    path.append(mFileName); // '../MCAM_*.webm'
+    if (format == FORMAT_MOV) {
+
+        path.resize(path.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
+        path.append(MOV_FILE_EXTENSION); // '.mov'
+    }
+    return path;
+}
+std::string Video::getEncoder(bool sound, bool webm, bool mov) const {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - s:%s; w:%s; m:%s"), __PRETTY_FUNCTION__, __LINE__, (sound)? "true":"false",
+            (webm)? "true":"false", (mov)? "true":"false");
+    assert((webm) || (mov));
+
+    std::string pipeline;
+    if (webm) {
+
+        pipeline.append("webmmux name=webm ! filesink location=");
+        pipeline.append(getPath(FORMAT_WEBM));
+        pipeline += ' ';
+    }
+    if (mov) {
+
+        pipeline.append("qtmux name=mov ! filesink location=");
+        pipeline.append(getPath(FORMAT_MOV));
+        pipeline += ' ';
+    }
+
+    // Decode JPEG frames once then tee them into each encoder branch (with the take encoder profile)
+    pipeline.append(VIDEO_FRAMES_SRC);
+    pipeline.append(" ! jpegdec ! videoconvert ! ");
+    if ((webm) && (mov))
+        pipeline.append("tee name=video ! queue ! ");
+    if (webm) {
+
+        pipeline.append(EncoderProfile::getVP8(mEncProfile, mFPS));
+        pipeline.append(" ! queue ! webm.video_0");
+    }
+    if ((webm) && (mov))
+        pipeline.append(" video. ! queue ! ");
+    if (mov) {
+
+        pipeline.append(EncoderProfile::getX264(mEncProfile, mFPS));
+        pipeline.append(" ! " VIDEO_MOV_CAPS " ! queue ! mov.video_0");
+    }
+
+    if (sound) { // ...same for the audio
+
+        pipeline.append(" filesrc location=");
+        pipeline.append(mPicFolder);
+        pipeline.append(MCAM_SUB_FOLDER);
+        pipeline.append(MCAM_MIC_FILENAME);
+        pipeline.append(WAV_FILE_EXTENSION);
+        pipeline.append(" ! wavparse ! audioconvert ! ");
+        if ((webm) && (mov))
+            pipeline.append("tee name=audio ! " VIDEO_AUDIO_QUEUE " ! " VIDEO_WEBM_AUDIO " ! queue ! webm.audio_0 audio. ! "
+                            VIDEO_AUDIO_QUEUE " ! " VIDEO_MOV_AUDIO " ! queue ! mov.audio_0");
+        else if (webm)
+            pipeline.append(VIDEO_WEBM_AUDIO " ! queue ! webm.audio_0");
+        else
+            pipeline.append(VIDEO_MOV_AUDIO " ! queue ! mov.audio_0");
+    }
+    return pipeline;
+}
+void Video::publish(unsigned char format, bool done) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%d; d:%s"), __PRETTY_FUNCTION__, __LINE__, format, (done)? "true":"false");
+    assert(format < FORMAT_COUNT);
+    assert(!mRenditions[format].buffer);
+
+    int size = 0;
+    char* buffer = (done)? load(getPath(format), size):NULL;
+
+    // Never give a buffer that is not entirely loaded (see 'select')
+    mRenditionMutex.lock();
+    mRenditions[format].buffer = buffer;
+    mRenditions[format].size = size;
+    mRenditions[format].state = (buffer)? RENDITION_READY:RENDITION_FAILED;
+    mRenditionMutex.unlock();
+}
+bool Video::launch(const std::string &pipeline, unsigned char streams) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - p:%s; s:%d (c:%d)"), __PRETTY_FUNCTION__, __LINE__, pipeline.c_str(),
+            streams, mTimeline.getCount());
+    GError* error = NULL;
+    GstElement* launch = gst_parse_launch(pipeline.c_str(), &error);
+    if (error) {
+
+        LOGE(LOG_FORMAT(" - gStreamer error: %s"), __PRETTY_FUNCTION__, __LINE__, error->message);
+        g_clear_error(&error);
+        assert(NULL);
+        return false;
+    }
+    GstElement* frames = gst_bin_get_by_name(GST_BIN(launch), "frames");
+    assert(frames);
+    gst_element_set_state(launch, GST_STATE_PLAYING);
+
+    // Push the timeline source JPEG files with their presentation time (variable frame rate)
+    FramePath path(&mPicFolder);
+    unsigned int begin = CamFrame::now();
+
+    GstClockTime pts = 0;
+    short pushed = 0;
+    bool done = true;
+    for (short i = 0, held = 1; i < mTimeline.getCount(); i += held) {
+
+        const char* fileName = mTimeline.getPath(&path, i, JPEG_FILE_EXTENSION);
+        std::ifstream jpeg(fileName, std::ifstream::binary);
+        if (!jpeg.is_open()) {
+
+            LOGW(LOG_FORMAT(" - Missing file %s"), __PRETTY_FUNCTION__, __LINE__, fileName);
+            done = false; // Truncated video
+            break;
+        }
+        jpeg.seekg(0, std::ifstream::end);
+        gsize size = static_cast<gsize>(jpeg.tellg());
+        jpeg.seekg(0, std::ifstream::beg);
+
+        GstBuffer* buffer = gst_buffer_new_allocate(NULL, size, NULL);
+        GstMapInfo map;
+        gst_buffer_map(buffer, &map, GST_MAP_WRITE);
+        jpeg.read(reinterpret_cast<char*>(map.data), size);
+        gst_buffer_unmap(buffer, &map);
+        jpeg.close();
+
+        // Held frame: Encoded once & displayed during all its entries
+        held = mTimeline.getHeld(i);
+        GstClockTime duration = 0;
+        for (short j = 0; j < held; ++j)
+            duration += mTimeline.get(i + j)->duration * GST_MSECOND;
+
+        GST_BUFFER_PTS(buffer) = pts;
+        GST_BUFFER_DURATION(buffer) = duration;
+        pts += duration;
+        ++pushed;
+
+        if (gst_app_src_push_buffer(GST_APP_SRC(frames), buffer) != GST_FLOW_OK) {
+
+            done = false; // Error (see bus message below)
+            break;
+        }
+        if (mAbort)
+            break;
+    }
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - %d frame(s) encoded for %d displayed"), __PRETTY_FUNCTION__, __LINE__,
+            pushed, mTimeline.getCount());
+    gst_app_src_end_of_stream(GST_APP_SRC(frames));
+    gst_object_unref(frames);
+
+    // Wait EOS
+    GstMessage* msg = gst_bus_poll(gst_element_get_bus(launch), (GstMessageType)(GST_MESSAGE_ERROR | GST_MESSAGE_EOS), -1);
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+
+        GError* err = NULL;
+        gchar* dbg = NULL;
+        gst_message_parse_error(msg, &err, &dbg);
+        if (err) {
+
+            LOGE(LOG_FORMAT(" - gStreamer error: %s (%s)"), __PRETTY_FUNCTION__, __LINE__, err->message,
+                    (dbg)? dbg:"none");
+            g_error_free(err);
+        }
+        done = false;
+    }
+    gst_message_unref(msg);
+    gst_element_set_state(launch, GST_STATE_NULL);
+    gst_object_unref(GST_OBJECT(launch));
+
+    if ((done) && (!mAbort))
+        EncoderProfile::measure(mEncProfile, pushed, CamFrame::now() - begin, streams);
+    return done;
+}
+#endif
+void Video::profile(short frames, unsigned char streams) {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%d; s:%d (p:%d)"), __PRETTY_FUNCTION__, __LINE__, frames, streams,
+            mProfile);
+    mEncProfile = (mProfile != EncoderProfile::PROFILE_AUTO)? mProfile:EncoderProfile::choose(frames, streams);
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Encoder profile: %s (%.1f fps measured)"), __PRETTY_FUNCTION__, __LINE__,
+            EncoderProfile::getName(mEncProfile), EncoderProfile::getFPS(mEncProfile));
+}
+void Video::timeline() {
+
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (c:%d; fps:%d)"), __PRETTY_FUNCTION__, __LINE__, mTimeline.getCount(),
+            mFPS);
+
+    // Capture time -> Duration (entries without capture time: Bullet time frames)
+    // 0ms:41900 | 1ms:41962 | 2ms:42030 | 3ms:0 | 4ms:0 | 5ms:42150 | 6ms:42211
+    // 0ms:62    | 1ms:68    | 2ms:62    | 3ms:62 | 4ms:62 | 5ms:61  | 6ms:62
+    unsigned int first = (mTimeline.getCount())? mTimeline.get(0)->stamp:0;
+    mAudioSkip = (first > mRecorder->mStart)? first - mRecorder->mStart:0;
+    mBulletStart = 0;
+    mBulletLength = 0;
+    short before = 0; // Entries B4 bullet time
+    short bullet = 0; // Bullet time entries
+    for (short i = 0; i < mTimeline.getCount(); ++i) {
+
+        FrameTimeline::Entry* entry = mTimeline.get(i);
+        bool captured = (entry->stamp != 0);
+#ifdef __ANDROID__
+        if ((captured) && ((i + 1) < mTimeline.getCount()) && (mTimeline.get(i + 1)->stamp > entry->stamp))
+            entry->duration = mTimeline.get(i + 1)->stamp - entry->stamp;
+        else
+#endif
+            entry->duration = 1000 / mFPS; // iOS: Fixed frame rate encoding ('multifilesrc' caps - see 'PROC_SAVE')
+
+        if (!bullet) {
+            if (captured) {
+
+                mBulletStart += entry->duration;
+                ++before;
+            }
+            else {
+
+                mBulletLength = entry->duration;
+                ++bullet;
+            }
+        }
+        else if (!captured) {
+
+            mBulletLength += entry->duration;
+            ++bullet;
+        }
+    }
+#ifndef __ANDROID__
+    // Same positions as the fixed frame rate video (without rounding the duration of each entry)
+    mBulletStart = (static_cast<unsigned int>(before) * 1000) / mFPS;
+    mBulletLength = (static_cast<unsigned int>(bullet) * 1000) / mFPS;
+#endif
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Skip:%u Bullet:%u Length:%u (ms)"), __PRETTY_FUNCTION__, __LINE__, mAudioSkip,
+            mBulletStart, mBulletLength);
+}
 bool Video::save(const FrameList* clients, bool landscape) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - c:%x; l:%s (b:%d; a:%d)"), __PRETTY_FUNCTION__, __LINE__, clients,
@@ -668,48 +1347,32 @@ bool Video::save(const FrameList* clients, bool landscape) {
     mLandscape = landscape;
     mFPS = mRecorder->getFPS();
 
-    //
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Rename JPEG files B4 bullet time effect"), __PRETTY_FUNCTION__, __LINE__);
-    std::string prevFile(Picture::getFileName(&mPicFolder, JPEG_FILE_EXTENSION));
-    std::string newFile(prevFile);
-
-    newFile.resize(newFile.size() - 7); // '000.jpg' contains 7 characters
-    size_t fileSize = newFile.size(); // File size without frame index
-
-    // img_0.jpg -> img_0.jpg
-    // img_2.jpg -> img_1.jpg
-    // img_4.jpg -> img_2.jpg
-    mPicCount = 0;
-    for (unsigned char i = 0; i < static_cast<unsigned char>(mRecorder->mBefore.size()); ++i) {
-        if (mRecorder->mBefore[i]->status != Recorder::STATUS_DONE)
-            continue;
+    if ((mRecorder->isCompress()) && (!mRecorder->write())) {
 
-        if (mRecorder->mBefore[i]->index == mPicCount) {
-            ++mPicCount;
-            continue;
-        }
-        prevFile.resize(fileSize); // '../img_'
-        newFile.assign(prevFile); // ...
-        prevFile.append(numToStr<short>(mRecorder->mBefore[i]->index));
-        prevFile.append(JPEG_FILE_EXTENSION);
-        newFile.append(numToStr<short>(mPicCount++));
-        newFile.append(JPEG_FILE_EXTENSION);
-
-        if (rename(prevFile.c_str(), newFile.c_str())) { // Error
-
-            LOGE(LOG_FORMAT(" - Failed to rename file %s to %s"), __PRETTY_FUNCTION__, __LINE__, prevFile.c_str(),
-                    newFile.c_str());
-            clear();
-            assert(NULL);
+        LOGE(LOG_FORMAT(" - Failed to write JPEG files"), __PRETTY_FUNCTION__, __LINE__);
+        clear();
+        assert(NULL);
 #ifdef __ANDROID__
-            alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
+        alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
 #else
-            alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
+        alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
 #endif
-            return false;
-        }
+        return false;
     }
-    if (!mPicCount) {
+
+    //
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Add B4 bullet time frames into the timeline"), __PRETTY_FUNCTION__, __LINE__);
+    // img_0.jpg, img_2.jpg, img_4.jpg (ordered from the oldest frame for a continuous recording)
+    mTimeline.clear();
+    mTimeline.reserve(static_cast<short>(mRecorder->mBefore.size() + mRecorder->mAfter.size()) +
+            ((static_cast<short>(clients->size()) + 1) * MCAM_FPS_FACTOR(mFPS) * 2));
+    for (short i = 0; i < static_cast<short>(mRecorder->mBefore.size()); ++i) {
+        if (mRecorder->getBefore(i)->status != Recorder::STATUS_DONE)
+            continue;
+
+        mTimeline.add(mRecorder->getBefore(i)->index, mRecorder->getBefore(i)->stamp);
+    }
+    if (!mTimeline.getCount()) {
 
         LOGE(LOG_FORMAT(" - No B4 frame count"), __PRETTY_FUNCTION__, __LINE__);
         clear();
@@ -727,10 +1390,7 @@ bool Video::save(const FrameList* clients, bool landscape) {
             mFPS);
     unsigned char lag = static_cast<unsigned char>((BULLET_TIME_LAG / 1000.f) * mFPS) + 1;
 
-    // img_700.jpg -> img_109.jpg
-    // img_701.jpg -> img_110.jpg
-    // img_703.jpg -> img_111.jpg
-
+    // img_700.jpg, img_701.jpg, img_703.jpg
     for (unsigned char i = 0; i < static_cast<unsigned char>(mRecorder->mAfter.size()); ++i) {
         if (mRecorder->mAfter[i]->status != Recorder::STATUS_DONE)
             continue;
@@ -738,44 +1398,19 @@ bool Video::save(const FrameList* clients, bool landscape) {
         if (i == lag)
             break;
 
-        prevFile.resize(fileSize); // '../img_'
-        newFile.assign(prevFile); // ...
-        prevFile.append(numToStr<short>(mRecorder->mAfter[i]->index));
-        prevFile.append(JPEG_FILE_EXTENSION);
-        newFile.append(numToStr<short>(mPicCount++));
-        newFile.append(JPEG_FILE_EXTENSION);
-
-        if (rename(prevFile.c_str(), newFile.c_str())) { // Error
-
-            LOGE(LOG_FORMAT(" - Failed to rename file %s to %s"), __PRETTY_FUNCTION__, __LINE__, prevFile.c_str(),
-                    newFile.c_str());
-            clear();
-            assert(NULL);
-#ifdef __ANDROID__
-            alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
-#else
-            alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
-#endif
-            return false;
-        }
-    }
-
-    --mPicCount; // Current frame index
-    for (unsigned char i = 1; i < MCAM_FPS_FACTOR(mFPS); ++i) { // Repeat server frame
-
-        copyFile(&prevFile, &newFile, fileSize, mPicCount, mPicCount + 1);
-        ++mPicCount;
+        mTimeline.add(mRecorder->mAfter[i]->index, mRecorder->mAfter[i]->stamp);
     }
-    ++mPicCount; // Next frame index
+    short server = mTimeline.getCount() - 1; // Server frame
+    for (unsigned char i = 1; i < MCAM_FPS_FACTOR(mFPS); ++i) // Repeat server frame
+        mTimeline.repeat(server);
 
     //
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Organize JPEG files"), __PRETTY_FUNCTION__, __LINE__);
-    // img_001.jpg -> img_98.jpg + img_99.jpg + img_100.jpg (x3)
-    // img_003.jpg -> img_101.jpg + img_102.jpg + img_103.jpg (x3)
-    // img_004.jpg -> img_104.jpg + img_105.jpg + img_106.jpg (x3)
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Add bullet time frames into the timeline"), __PRETTY_FUNCTION__, __LINE__);
+    // img_001.jpg (x3), img_003.jpg (x3), img_004.jpg (x3)
 
 #ifdef __ANDROID__
     miOS = false;
+    mAndroid = false;
 #endif
     mClientCount = 0;
     for (unsigned char i = 0; i < static_cast<unsigned char>(clients->size()); ++i) { // ...common direction (x3)
@@ -783,7 +1418,9 @@ bool Video::save(const FrameList* clients, bool landscape) {
         if (!(*clients)[i]->done)
             continue;
 
-        if (!(*clients)[i]->android)
+        if ((*clients)[i]->android)
+            mAndroid = true;
+        else
             miOS = true;
 #else
         if (!(*clients)[i])
@@ -793,86 +1430,48 @@ bool Video::save(const FrameList* clients, bool landscape) {
         assert(get(i));
         assert(get(i)->isDone());
 
-        prevFile.resize(fileSize); // '../img_'
-        newFile.assign(prevFile); // ...
-        switch (DIGIT_COUNT(i + 1)) {
-            case 1: prevFile.append("00"); break;
-            case 2: prevFile += '0'; break;
-        }
-        prevFile.append(numToStr<short>(static_cast<short>(i + 1)));
-        prevFile.append(JPEG_FILE_EXTENSION);
-        newFile.append(numToStr<short>(mPicCount));
-        newFile.append(JPEG_FILE_EXTENSION);
+        mTimeline.addClient(i + 1);
+        short client = mTimeline.getCount() - 1;
+        for (unsigned char j = 1; j < MCAM_FPS_FACTOR(mFPS); ++j) // Repeat bullet time frame(s)
+            mTimeline.repeat(client);
 
-        if (rename(prevFile.c_str(), newFile.c_str())) { // Error
-
-            LOGE(LOG_FORMAT(" - Failed to rename file %s to %s"), __PRETTY_FUNCTION__, __LINE__, prevFile.c_str(),
-                    newFile.c_str());
-            clear();
-            assert(NULL);
-#ifdef __ANDROID__
-            alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
-#else
-            alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
-#endif
-            return false;
-        }
-        for (unsigned char j = 1; j < MCAM_FPS_FACTOR(mFPS); ++j) { // Repeat bullet time frame(s)
-
-            copyFile(&prevFile, &newFile, fileSize, mPicCount, mPicCount + 1);
-            ++mPicCount;
-        }
         ++mClientCount;
     }
     clear(false);
 
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Add JPEG files for back direction (cnt:%d)"), __PRETTY_FUNCTION__, __LINE__,
-            mClientCount);
-    // img_97.jpg, img_98.jpg, img_99.jpg, img_100.jpg, img_101.jpg, img_102.jpg
-    // Add files (x3):
-    // img_103.jpg, img_104.jpg, img_105.jpg, img_106.jpg, img_107.jpg, img_108.jpg
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Add back direction into the timeline (cnt:%d)"), __PRETTY_FUNCTION__,
+            __LINE__, mClientCount);
+    // img_003.jpg (x3), img_001.jpg (x3), server frame (x3)
 
-    short backCount = mPicCount;
+    short backCount = mTimeline.getCount() - 1;
     short bulletCnt = mClientCount;
     while (bulletCnt > LIBENG_NO_DATA) {
 
         for (unsigned char i = 0; i < MCAM_FPS_FACTOR(mFPS); ++i) // Repeat server frame
-            copyFile(&prevFile, &newFile, fileSize, backCount--, ++mPicCount);
+            mTimeline.repeat(backCount--);
 
         --bulletCnt;
     }
 
     //
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Rename JPEG files after bullet time effect"), __PRETTY_FUNCTION__, __LINE__);
-    // img_700.jpg -> img_109.jpg
-    // img_701.jpg -> img_110.jpg
-    // img_703.jpg -> img_111.jpg
+    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Add after bullet time frames into the timeline"), __PRETTY_FUNCTION__,
+            __LINE__);
+    // img_704.jpg, img_705.jpg, img_707.jpg
 
     for (unsigned char i = 0; i < static_cast<unsigned char>(mRecorder->mAfter.size()); ++i) {
         if ((mRecorder->mAfter[i]->status != Recorder::STATUS_DONE) || (i < lag))
             continue;
 
-        prevFile.resize(fileSize); // '../img_'
-        newFile.assign(prevFile); // ...
-        prevFile.append(numToStr<short>(mRecorder->mAfter[i]->index));
-        prevFile.append(JPEG_FILE_EXTENSION);
-        newFile.append(numToStr<short>(++mPicCount)); // Next frame index
-        newFile.append(JPEG_FILE_EXTENSION);
-
-        if (rename(prevFile.c_str(), newFile.c_str())) { // Error
-
-            LOGE(LOG_FORMAT(" - Failed to rename file %s to %s"), __PRETTY_FUNCTION__, __LINE__, prevFile.c_str(),
-                    newFile.c_str());
-            clear();
-            assert(NULL);
+        mTimeline.add(mRecorder->mAfter[i]->index, mRecorder->mAfter[i]->stamp);
+    }
+    mPicCount = mTimeline.getCount();
+    timeline();
 #ifdef __ANDROID__
-            alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
+    // Held frames encoded once (see 'launch') into WebM & MOV when teed (see 'PROC_SAVE')
+    profile(mTimeline.getEncodedCount(), ((miOS) && (!mAndroid))? 2:1);
 #else
-            alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
+    profile(mPicCount); // All entries encoded ('multifilesrc')
 #endif
-            return false;
-        }
-    }
 
     start(PROC_SAVE);
     return true;
@@ -891,90 +1490,73 @@ void Video::extract() {
 }
 
 #ifdef __ANDROID__
-void Video::select(bool android) {
+bool Video::select(bool android) {
 
     LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - a:%s"), __PRETTY_FUNCTION__, __LINE__, (android)? "true":"false");
-    mBuffer = (android)? mBufferWEBM:mBufferMOV;
-    mBufferLen = (android)? mBufferLenWEBM:mBufferLenMOV;
+    mRenditionMutex.lock();
+    const Rendition* rendition = &mRenditions[(android)? FORMAT_WEBM:FORMAT_MOV];
+    bool ready = (rendition->state == RENDITION_READY);
+    mBuffer = (ready)? rendition->buffer:NULL;
+    mBufferLen = (ready)? rendition->size:0;
+    mRenditionMutex.unlock();
+    return ready;
 }
 #endif
-bool Video::open() {
+char* Video::load(const std::string &fileName, int &size) const {
 
-    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (m:%s; f:%s)"), __PRETTY_FUNCTION__, __LINE__, mMovFolder.c_str(),
-            mFileName.c_str());
-    assert(mMovFolder.length());
-    assert(mFileName.length());
-    assert(!mBuffer);
-
-    std::string fileName(mMovFolder);
-    fileName.append(mFileName);
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - f:%s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
     std::ifstream ifs(fileName.c_str(), std::ifstream::binary);
     if (!ifs.is_open()) {
 
-        LOGE(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
-        assert(NULL);
-        return false;
+        LOGW(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
+        return NULL;
     }
     std::filebuf* pbuf = ifs.rdbuf();
-#ifdef __ANDROID__
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
-    assert(!mBufferWEBM);
 
-    mBufferLenWEBM = static_cast<int>(pbuf->pubseekoff(0, ifs.end, ifs.in));
-    if (mBufferLenWEBM < 1) {
-#else
-    mBufferLen = static_cast<int>(pbuf->pubseekoff(0, ifs.end, ifs.in));
-    if (mBufferLen < 1) {
-#endif
+    size = static_cast<int>(pbuf->pubseekoff(0, ifs.end, ifs.in));
+    if (size < 1) {
+
         ifs.close();
-        LOGE(LOG_FORMAT(" - Wrong %s file size (%d)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str(), mBufferLen);
-        assert(NULL);
-        return false;
+        LOGW(LOG_FORMAT(" - Wrong %s file size (%d)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str(), size);
+        size = 0;
+        return NULL;
     }
     pbuf->pubseekpos(0, ifs.in);
 
-#ifdef __ANDROID__
-    mBufferWEBM = new char[mBufferLenWEBM];
-    pbuf->sgetn(mBufferWEBM, mBufferLenWEBM);
-#else
-    mBuffer = new char[mBufferLen];
-    pbuf->sgetn(mBuffer, mBufferLen);
-#endif
+    char* buffer = BufferPool::get(static_cast<size_t>(size));
+    pbuf->sgetn(buffer, size);
     ifs.close();
+    return buffer;
+}
+bool Video::open() {
 
-#ifdef __ANDROID__
-    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(), __PRETTY_FUNCTION__, __LINE__);
-    assert(!mBufferMOV);
-
-    fileName.resize(fileName.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
-    fileName.append(MOV_FILE_EXTENSION);
+    LOGV(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - (m:%s; f:%s)"), __PRETTY_FUNCTION__, __LINE__, mMovFolder.c_str(),
+            mFileName.c_str());
+    assert(mMovFolder.length());
+    assert(mFileName.length());
+    assert(!mBuffer);
 
-    ifs.open(fileName.c_str(), std::ifstream::binary);
-    if (!ifs.is_open()) {
+#ifdef __ANDROID__
+    // Renditions loaded by the process threads (MOV may still be in progress - see 'PROC_EXTRACT')
+    if (mRenditions[FORMAT_WEBM].state != RENDITION_READY) {
 
-        LOGW(LOG_FORMAT(" - Failed to open file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
-        //assert(NULL); // MOV file not exists (possible case)
-        return true;
+        LOGE(LOG_FORMAT(" - No WebM video available"), __PRETTY_FUNCTION__, __LINE__);
+        assert(NULL);
+        return false;
     }
-    pbuf = ifs.rdbuf();
-
-    mBufferLenMOV = static_cast<int>(pbuf->pubseekoff(0, ifs.end, ifs.in));
-    if (mBufferLenMOV < 1) {
+    return true;
+#else
+    std::string fileName(mMovFolder);
+    fileName.append(mFileName);
+    mBuffer = load(fileName, mBufferLen);
+    if (!mBuffer) {
 
-        ifs.close();
-        LOGW(LOG_FORMAT(" - Wrong %s file size (%d)"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str(), mBufferLen);
-        //assert(NULL); // ...
-        mBufferLenMOV = 0;
-        return true;
+        LOGE(LOG_FORMAT(" - Failed to load file %s"), __PRETTY_FUNCTION__, __LINE__, fileName.c_str());
+        assert(NULL);
+        return false;
     }
-    pbuf->pubseekpos(0, ifs.in);
-
-    mBufferMOV = new char[mBufferLenMOV];
-    pbuf->sgetn(mBufferMOV, mBufferLenMOV);
-    ifs.close();
-
-#endif
     return true;
+#endif
 }
 
 void Video::start(unsigned char process) {
@@ -1072,51 +1654,47 @@ void Video::processThreadRunning(unsigned char proc) {
             mFileName.append(numToStr<short>(now->tm_sec));
             mFileName.append(WEBM_FILE_EXTENSION);
 
-            fileName.assign(Picture::getFileName(&mPicFolder, JPEG_FILE_EXTENSION));
-            fileName.resize(fileName.size() - 7); // '000.jpg' contains 7 characters
-            if (!sound) {
+            // MOV rendition for iOS clients: Encoded together with the WebM (single JPEG decoding) only if no Android
+            // client is waiting for it, lazily once the WebM has been given otherwise (see 'PROC_EXTRACT')
+            bool mov = (miOS) && (!mAndroid);
+            setRendition(FORMAT_MOV, (miOS)? RENDITION_PENDING:RENDITION_NONE);
+            bool done = launch(getEncoder(sound, true, mov), (mov)? 2:1);
 
-                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Without sound"), __PRETTY_FUNCTION__, __LINE__);
-                mfsrc.assign("multifilesrc location=");
-                mfsrc.append(fileName); // '../img_'
-                mfsrc.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
-                mfsrc.append(numToStr<short>(static_cast<short>(mFPS)));
-                mfsrc.append("/1\" ! jpegdec ! videoconvert ! vp8enc ! webmmux ! filesink location=");
-                mfsrc.append(mMovFolder);
-                mfsrc.append(mFileName);
-            }
-            else {
+            std::string movFile(getPath(FORMAT_MOV));
+            if ((!done) && (mov) && (!mAbort)) {
 
-                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - With sound"), __PRETTY_FUNCTION__, __LINE__);
-                mfsrc.assign("webmmux name=mux ! filesink location=");
-                mfsrc.append(mMovFolder);
-                mfsrc.append(mFileName);
-                mfsrc.append(" multifilesrc location=");
-                mfsrc.append(fileName); // '../img_'
-                mfsrc.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
-                mfsrc.append(numToStr<short>(static_cast<short>(mFPS)));
-                mfsrc.append("/1\" ! jpegdec ! videoconvert ! vp8enc ! queue ! mux.video_0 filesrc location=");
-                fileName.assign(mPicFolder);
-                fileName.append(MCAM_SUB_FOLDER);
-                fileName.append(MCAM_MIC_FILENAME);
-                fileName.append(WAV_FILE_EXTENSION);
-                mfsrc.append(fileName);
-                mfsrc.append(" ! wavparse ! audioconvert ! vorbisenc ! queue ! mux.audio_0");
+                LOGW(LOG_FORMAT(" - Failed to create WebM & MOV video files: WebM only"), __PRETTY_FUNCTION__,
+                        __LINE__);
+                //assert(NULL); // Sorry for all iOS clients!
+
+                // Delete wrong MOV file (if any)
+                if (boost::filesystem::exists(movFile))
+                    boost::filesystem::remove(movFile);
+
+                mov = false;
+                setRendition(FORMAT_MOV, RENDITION_FAILED);
+                done = launch(getEncoder(sound, true, mov));
             }
-            if (!Picture::gstLaunch(mfsrc)) {
+            if (!done) {
 
-                // Delete wrong WebM file (if any)
-                fileName.assign(mMovFolder);
-                fileName.append(mFileName);
+                // Delete wrong WebM & MOV files (if any)
+                fileName.assign(getPath(FORMAT_WEBM));
                 if (boost::filesystem::exists(fileName))
                     boost::filesystem::remove(fileName);
+                if ((mov) && (boost::filesystem::exists(movFile)))
+                    boost::filesystem::remove(movFile);
 
                 alertMessage(LOG_LEVEL_VIDEO, SAVE_VIDEO_ERROR);
                 mStatus = LIBENG_NO_DATA; // Error
                 mAbort = true;
                 break;
             }
+            if (mov)
+                publish(FORMAT_MOV, true);
+            publish(FORMAT_WEBM, true); // Ready to be uploaded to Android clients
             alertMessage(LOG_LEVEL_VIDEO, STORE_MEDIA_SUCCEEDED);
+            LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - WebM%s video file created"), __PRETTY_FUNCTION__, __LINE__,
+                    (mov)? " & MOV":"");
 
             //
             if (aborted(__PRETTY_FUNCTION__, __LINE__, proc))
@@ -1128,62 +1706,6 @@ void Video::processThreadRunning(unsigned char proc) {
             videoTitle.append(Share::extractDate(mFileName));
             Storage::getInstance()->saveMedia(fileName, WEBM_MIME_TYPE, videoTitle);
 
-            // Check if needed to create MOV video file (existing iOS client)
-            if (miOS) {
-
-                //
-                if (aborted(__PRETTY_FUNCTION__, __LINE__, proc))
-                    break;
-                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Convert from WebM to MOV"), __PRETTY_FUNCTION__, __LINE__);
-                if (!sound) {
-
-                    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Without sound"), __PRETTY_FUNCTION__, __LINE__);
-                    mfsrc.assign("filesrc location=");
-                    mfsrc.append(fileName); // '../MCAM_*.webm'
-                    mfsrc.append(" ! matroskademux ! vp8dec ! videoconvert ! x264enc ! video/x-h264,profile=baseline"
-                                 " ! qtmux ! filesink location=");
-                    mfsrc.append(fileName); // '../MCAM_*.webm'
-                    mfsrc.resize(mfsrc.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
-                    mfsrc.append(MOV_FILE_EXTENSION); // '.mov'
-                }
-                else {
-
-                    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - With sound"), __PRETTY_FUNCTION__, __LINE__);
-                    mfsrc.assign("qtmux name=mux ! filesink location=");
-                    mfsrc.append(fileName); // '../MCAM_*.webm'
-                    mfsrc.resize(mfsrc.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
-                    mfsrc.append(MOV_FILE_EXTENSION); // '.mov'
-                    mfsrc.append(" filesrc location=");
-                    mfsrc.append(fileName); // '../MCAM_*.webm'
-                    mfsrc.append(" ! matroskademux ! vp8dec ! videoconvert ! x264enc ! video/x-h264,profile=baseline ! queue"
-                                 " ! mux.video_0 filesrc location=");
-                    mfsrc.append(mPicFolder);
-                    mfsrc.append(MCAM_SUB_FOLDER);
-                    mfsrc.append(MCAM_MIC_FILENAME);
-                    mfsrc.append(WAV_FILE_EXTENSION);
-                    mfsrc.append(" ! wavparse ! audioconvert ! voaacenc ! queue ! mux.audio_0");
-                }
-                if (!Picture::gstLaunch(mfsrc)) {
-
-                    LOGW(LOG_FORMAT(" - Failed to create MOV video file"), __PRETTY_FUNCTION__, __LINE__);
-                    //assert(NULL); // Sorry for all iOS clients!
-
-                    // Delete wrong MOV file (if any)
-                    fileName.resize(fileName.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
-                    fileName.append(MOV_FILE_EXTENSION); // '.mov'
-                    if (boost::filesystem::exists(fileName))
-                        boost::filesystem::remove(fileName);
-                }
-#ifdef DEBUG
-                else {
-                    LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - MOV video file created"), __PRETTY_FUNCTION__, __LINE__);
-                }
-            }
-            else {
-                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - No need to create MOV video file"), __PRETTY_FUNCTION__, __LINE__);
-#endif
-            }
-
 #else // iOS
 
             LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Convert AAC into WAV"), __PRETTY_FUNCTION__, __LINE__);
@@ -1235,8 +1757,26 @@ void Video::processThreadRunning(unsigned char proc) {
                 break;
             LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Convert all JPEG to MOV"), __PRETTY_FUNCTION__, __LINE__);
 
-            fileName.assign(Picture::getFileName(&mPicFolder, JPEG_FILE_EXTENSION));
-            fileName.resize(fileName.size() - 7); // '000.jpg' contains 7 characters
+            // Hard link timeline frames into a contiguous sequence (no JPEG file copied)
+            FramePath srcPath(&mPicFolder);
+            FramePath seqPath(&mPicFolder, SEQ_FILE_NAME);
+            short linked = 0;
+            for ( ; linked < mPicCount; ++linked) {
+                if (link(mTimeline.getPath(&srcPath, linked, JPEG_FILE_EXTENSION),
+                        seqPath.get(linked, JPEG_FILE_EXTENSION))) {
+
+                    LOGE(LOG_FORMAT(" - Failed to link file %s"), __PRETTY_FUNCTION__, __LINE__,
+                            seqPath.get(linked, JPEG_FILE_EXTENSION));
+                    break;
+                }
+            }
+            if (linked != mPicCount) {
+
+                alertMessage(LOG_LEVEL_VIDEO, 2.5, SAVE_VIDEO_ERROR);
+                mStatus = LIBENG_NO_DATA; // Error
+                break;
+            }
+            fileName.assign(seqPath.getPrefix());
             mFileName.assign(VIDEO_FILENAME);
 
             time_t curDate = time(NULL);
@@ -1264,11 +1804,12 @@ void Video::processThreadRunning(unsigned char proc) {
 
                 LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Without sound"), __PRETTY_FUNCTION__, __LINE__);
                 mfsrc.assign("multifilesrc location=");
-                mfsrc.append(fileName); // '.../img_'
+                mfsrc.append(fileName); // '.../seq_'
                 mfsrc.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
                 mfsrc.append(numToStr<short>(static_cast<short>(mFPS)));
-                mfsrc.append("/1\" ! jpegdec ! videoconvert ! x264enc ! video/x-h264,profile=baseline ! qtmux"
-                             " ! filesink location=");
+                mfsrc.append("/1\" ! jpegdec ! videoconvert ! ");
+                mfsrc.append(EncoderProfile::getX264(mEncProfile, mFPS));
+                mfsrc.append(" ! video/x-h264,profile=baseline ! qtmux ! filesink location=");
                 mfsrc.append(mMovFolder);
                 mfsrc.append(mFileName);
             }
@@ -1279,11 +1820,12 @@ void Video::processThreadRunning(unsigned char proc) {
                 mfsrc.append(mMovFolder);
                 mfsrc.append(mFileName);
                 mfsrc.append(" multifilesrc location=");
-                mfsrc.append(fileName); // '../img_'
+                mfsrc.append(fileName); // '../seq_'
                 mfsrc.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
                 mfsrc.append(numToStr<short>(static_cast<short>(mFPS)));
-                mfsrc.append("/1\" ! jpegdec ! videoconvert ! x264enc ! video/x-h264,profile=baseline ! queue"
-                             " ! mux.video_0 filesrc location=");
+                mfsrc.append("/1\" ! jpegdec ! videoconvert ! ");
+                mfsrc.append(EncoderProfile::getX264(mEncProfile, mFPS));
+                mfsrc.append(" ! video/x-h264,profile=baseline ! queue ! mux.video_0 filesrc location=");
                 fileName.assign(mPicFolder);
                 fileName.append(MCAM_SUB_FOLDER);
                 fileName.append(MCAM_MIC_FILENAME);
@@ -1291,6 +1833,7 @@ void Video::processThreadRunning(unsigned char proc) {
                 mfsrc.append(fileName);
                 mfsrc.append(" ! wavparse ! audioconvert ! voaacenc ! queue ! mux.audio_0");
             }
+            unsigned int begin = CamFrame::now();
             if (!Picture::gstLaunch(mfsrc)) {
 
                 mFileName.clear();
@@ -1298,6 +1841,7 @@ void Video::processThreadRunning(unsigned char proc) {
                 mStatus = LIBENG_NO_DATA; // Error
                 break;
             }
+            EncoderProfile::measure(mEncProfile, mPicCount, CamFrame::now() - begin);
             fileName.assign(mMovFolder);
             fileName.append(mFileName);
 
@@ -1330,13 +1874,18 @@ void Video::processThreadRunning(unsigned char proc) {
             pipeline.append(fileName); // Video file name path
 #ifdef __ANDROID__
             if (miOS) // WebM video
-                pipeline.append(" ! matroskademux ! vp8dec ! jpegenc ! multifilesink location=");
+                pipeline.append(" ! matroskademux ! vp8dec");
             else // MOV file
-                pipeline.append(" ! qtdemux ! decodebin ! jpegenc ! multifilesink location=");
+                pipeline.append(" ! qtdemux ! decodebin");
 #else
             // MOV video
-            pipeline.append(" ! qtdemux ! decodebin ! jpegenc ! multifilesink location=");
+            pipeline.append(" ! qtdemux ! decodebin");
 #endif
+            // Held frames (encoded once with their whole duration - see 'launch') repeated at the video frame rate: One
+            // JPEG file per displayed frame (see 'update')
+            pipeline.append(" ! videorate ! video/x-raw,framerate=");
+            pipeline.append(numToStr<short>(static_cast<short>(mFPS)));
+            pipeline.append("/1 ! jpegenc ! multifilesink location=");
             std::string filePath(mPicFolder);
             filePath.append(MCAM_SUB_FOLDER);
             pipeline.append(filePath);
@@ -1356,6 +1905,11 @@ void Video::processThreadRunning(unsigned char proc) {
             mPicCount = static_cast<short>([[[NSFileManager defaultManager]
                             contentsOfDirectoryAtPath:[NSString stringWithUTF8String:filePath.c_str()] error:nil] count]);
 #endif
+            mTimeline.clear(); // Video frames in display order: 'img_<N>.jpg'
+            mTimeline.reserve(mPicCount);
+            for (short i = 0; i < mPicCount; ++i)
+                mTimeline.add(i, 0);
+
             //assert(mPicCount < ((MAX_VIDEO_FPS * (RECORD_DURATION_BEFORE + RECORD_DURATION_AFTER)) + (255 * 3))); // x2 x3
             //assert(mPicCount > (3 * 3)); // x2 x3
 
@@ -1405,6 +1959,7 @@ void Video::processThreadRunning(unsigned char proc) {
 
                 fileName.assign(Picture::getFileName(&mPicFolder, JPEG_FILE_EXTENSION));
                 fileName.resize(fileName.size() - 7); // '000.jpg' contains 7 characters
+                profile(mPicCount);
                 if (!sound) {
 
                     LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Without sound"), __PRETTY_FUNCTION__, __LINE__);
@@ -1412,7 +1967,9 @@ void Video::processThreadRunning(unsigned char proc) {
                     pipeline.append(fileName); // '../img_'
                     pipeline.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
                     pipeline.append(numToStr<short>(static_cast<short>(mFPS)));
-                    pipeline.append("/1\" ! jpegdec ! videoconvert ! vp8enc ! webmmux ! filesink location=");
+                    pipeline.append("/1\" ! jpegdec ! videoconvert ! ");
+                    pipeline.append(EncoderProfile::getVP8(mEncProfile, mFPS));
+                    pipeline.append(" ! webmmux ! filesink location=");
                     pipeline.append(mMovFolder);
                     pipeline.append(mFileName); // '.webm'
                 }
@@ -1426,13 +1983,16 @@ void Video::processThreadRunning(unsigned char proc) {
                     pipeline.append(fileName); // '../img_'
                     pipeline.append("%d.jpg index=0 caps=\"image/jpeg,framerate=");
                     pipeline.append(numToStr<short>(static_cast<short>(mFPS)));
-                    pipeline.append("/1\" ! jpegdec ! videoconvert ! vp8enc ! queue ! mux.video_0 filesrc location=");
+                    pipeline.append("/1\" ! jpegdec ! videoconvert ! ");
+                    pipeline.append(EncoderProfile::getVP8(mEncProfile, mFPS));
+                    pipeline.append(" ! queue ! mux.video_0 filesrc location=");
                     pipeline.append(mPicFolder);
                     pipeline.append(MCAM_SUB_FOLDER);
                     pipeline.append(MCAM_MIC_FILENAME);
                     pipeline.append(OGG_FILE_EXTENSION);
                     pipeline.append(" ! oggdemux ! vorbisdec ! audioconvert ! vorbisenc ! queue ! mux.audio_0");
                 }
+                unsigned int begin = CamFrame::now();
 #ifdef DEBUG
                 if (!Picture::gstLaunch(pipeline, false)) {
 #else
@@ -1451,6 +2011,8 @@ void Video::processThreadRunning(unsigned char proc) {
                 }
                 else { // OK: MOV file converted into WebM
 
+                    EncoderProfile::measure(mEncProfile, mPicCount, CamFrame::now() - begin);
+
                     fileName.assign(mMovFolder);
                     fileName.append(mFileName); // '.webm'
                     fileName.resize(fileName.size() - sizeof(WEBM_FILE_EXTENSION) + 1);
@@ -1487,17 +2049,43 @@ void Video::processThreadRunning(unsigned char proc) {
         }
         case PROC_EXTRACT: { // Extract video & sound to be displayed
 
+#ifdef __ANDROID__
+            if (mRenditions[FORMAT_MOV].state == RENDITION_PENDING) { // Server with iOS client(s)
+
+                // Encode the MOV rendition now that the WebM is uploading (B4 extracting: JPEG files deleted)
+                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Convert all JPEG into MOV"), __PRETTY_FUNCTION__, __LINE__);
+                std::string wavFile(mPicFolder);
+                wavFile.append(MCAM_SUB_FOLDER);
+                wavFile.append(MCAM_MIC_FILENAME);
+                wavFile.append(WAV_FILE_EXTENSION);
+
+                std::string movFile(getPath(FORMAT_MOV));
+                bool done = launch(getEncoder(boost::filesystem::exists(wavFile), false, true));
+                if ((!done) && (boost::filesystem::exists(movFile)))
+                    boost::filesystem::remove(movFile); // Delete wrong MOV file
+
+                publish(FORMAT_MOV, (done) && (!mAbort));
+                LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - MOV video file %s"), __PRETTY_FUNCTION__, __LINE__,
+                        (mRenditions[FORMAT_MOV].state == RENDITION_READY)? "created":"not available");
+            }
+#endif
             //
             LOGI(LOG_LEVEL_VIDEO, 0, LOG_FORMAT(" - Extract JPEG files to display video"), __PRETTY_FUNCTION__, __LINE__);
             Picture texPic;
             texPic.setFolder(&mPicFolder);
+#ifdef __ANDROID__
+            FrameCodec codec; // Decoder session for all frames
+            texPic.setCodec(&codec);
+#endif
 
             for (short i = 0; i < mPicCount; ++i) {
                 if (aborted(__PRETTY_FUNCTION__, __LINE__, proc))
                     break;
+                if (mTimeline.get(i)->repeat)
+                    continue; // Source already extracted
 
                 boost::this_thread::sleep(boost::posix_time::milliseconds(20));
-                texPic.extract(mLandscape, i);
+                texPic.extract(mLandscape, mTimeline.get(i)->frame, mTimeline.get(i)->client);
             }
 
             //
@@ -1592,7 +2180,9 @@ void Video::update(const Game* game) {
     if (!mDelay)
         mDelay = now;
 
-    if (((now - mDelay) / game->mTickPerSecond) > (1.f / mFPS)) {
+    // Display duration of the current entry (none for an extracted video: fixed frame rate - see 'PROC_STORE')
+    unsigned int duration = mTimeline.get(mPicIdx)->duration;
+    if (((now - mDelay) / game->mTickPerSecond) > ((duration)? (duration / 1000.f):(1.f / mFPS))) {
 
         mDelay = now;
         if (++mPicIdx == mPicCount) {
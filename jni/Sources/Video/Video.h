@@ -16,21 +16,48 @@
 
 #ifdef __ANDROID__
 #include "Video/Picture.h"
+#include "Video/FrameRing.h"
+#include "Video/FrameQueue.h"
+#include "Video/CamFrame.h"
+#include "Video/FrameCodec.h"
+#include "Video/FrameTimeline.h"
+#include "Video/EncoderProfile.h"
 #else
 #include "Picture.h"
+#include "FrameRing.h"
+#include "FrameQueue.h"
+#include "CamFrame.h"
+#include "FrameTimeline.h"
+#include "EncoderProfile.h"
 #endif
 
 #define SCREEN_SCALE_RATIO          (5.f / 7.f)
 
-#define MAX_VIDEO_FPS               16
+#define MAX_VIDEO_FPS               30 // High frame rate capture (see 'Recorder::arm')
+#define DEF_VIDEO_FPS               16 // Default capture frame rate
 #define MIN_VIDEO_FPS               5
-#define MCAM_FPS_FACTOR(fps)        ((fps > 13)? 4:((fps > 8)? 3:2))
+#define BULLET_TIME_FPS             4 // Bullet time frame rate above the default frame rate (see below)
+#define MCAM_FPS_FACTOR(fps)        (((fps) > DEF_VIDEO_FPS)? (((fps) + BULLET_TIME_FPS - 1) / BULLET_TIME_FPS):\
+                                    (((fps) > 13)? 4:(((fps) > 8)? 3:2))) // Each bullet time frame repeat count
+                                    // -> Unchanged up to the default frame rate (high frame rates: ~4 fps)
 
 #define FREEZE_CAMERA_DURATION      700 // In milliseconds
 
+#ifdef COMPRESS_RECORD
+#define RECORD_DURATION_BEFORE      20 // Seconds (JPEG frames: ~50 KB per frame instead of 1.2 MB)
+#else
 #define RECORD_DURATION_BEFORE      7 // Seconds
+#endif
 #define RECORD_DURATION_AFTER       3 // ...
+#define RECORD_FRAMES_BEFORE        (RECORD_DURATION_BEFORE * MAX_VIDEO_FPS) // Maximum frame count
+#define RECORD_FRAMES_AFTER         (RECORD_DURATION_AFTER * MAX_VIDEO_FPS) // ...
 #define RECORD_MIC_FILENAME         "/micFile"
+#define RECORD_SPOOL_FILENAME       "/spool.bin"
+#define RECORD_SPOOL_FREE           250000000 // Free space kept besides the spool file (JPEG & video files - in byte)
+#define RECORD_COMPRESS_DELAY       2 // Ring slots for 2 seconds of capture when frames are compressed while recording
+#define RECORD_BENCH_FRAMES         4 // Frame count converted by the self-benchmark (see 'arm')
+#define RECORD_MAX_WORKER           4 // Maximum conversion thread count (whatever the core count)
+#define RECORD_WAKEUP_DELAY         20 // Conversion thread wake up delay when no frame has been signaled (in milliseconds)
 
 using namespace eng;
 
@@ -48,15 +75,43 @@ private:
     };
     typedef struct {
 
-        time_t elapsed;
+        unsigned int stamp; // Capture time (monotonic, in milliseconds)
         short index;
+        short slot; // Ring slot index (RING_NO_SLOT: Saved into BIN file or converted)
         unsigned char status;
 
+        char* jpeg; // JPEG buffer (compressed mode): From buffer pool
+        int jpegSize; // In byte
+        int jpegCapacity; // ...
+
+
     } RecFrame;
 
-    std::vector<RecFrame*> mBefore;
+    RecFrame mFrames[RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER]; // Pre-allocated frames
+    FrameRing mRing;
+    unsigned char mSpill;
+    bool mSpool;
+    bool mCompress;
+
+    std::vector<RecFrame*> mBefore; // Circular when full & continuous (see 'getBefore'); Reserved: Never reallocated
     std::vector<RecFrame*> mAfter;
 
+    bool mContinuous;
+    short mHead; // Index in 'mBefore' of the oldest frame
+    int mEvicted; // Frame count evicted from 'mBefore' (continuous mode)
+    unsigned int mStart; // Capture time of the first frame added (even evicted)
+
+    inline RecFrame* getBefore(short idx) const { // From oldest to newest frame
+        return mBefore[(mHead + idx) % static_cast<short>(mBefore.size())];
+    };
+
+    unsigned char mRate; // Capture frame rate (see 'arm')
+    unsigned int mBenchTime[CamFrame::RES_COUNT];
+    // -> Self-benchmark conversion duration per frame & session resolution (in milliseconds - 0: Not done yet)
+
+    inline short getMaxBefore() const { return static_cast<short>(RECORD_DURATION_BEFORE * mRate); }
+    inline short getMaxAfter() const { return static_cast<short>(RECORD_DURATION_AFTER * mRate); }
+
     inline short getDoneCount(bool before) const {
 
         short res = 0;
@@ -69,27 +124,37 @@ private:
     };
     inline unsigned char getFPS() const {
 
-        time_t last = 0, first = 0;
-        for (std::vector<RecFrame*>::const_iterator iter = mBefore.begin(); iter != mBefore.end(); ++iter) {
-            if ((*iter)->status != STATUS_DONE)
+        unsigned int last = 0, first = 0;
+        for (short i = 0; i < static_cast<short>(mBefore.size()); ++i) {
+            if (getBefore(i)->status != STATUS_DONE)
                 continue;
 
             if (!first)
-                first = (*iter)->elapsed;
-            last = (*iter)->elapsed;
+                first = getBefore(i)->stamp;
+            last = getBefore(i)->stamp;
         }
-        time_t duration = last - first;
+        unsigned int duration = last - first;
         last = first = 0;
         for (std::vector<RecFrame*>::const_iterator iter = mAfter.begin(); iter != mAfter.end(); ++iter) {
             if ((*iter)->status != STATUS_DONE)
                 continue;
 
             if (!first)
-                first = (*iter)->elapsed;
-            last = (*iter)->elapsed;
+                first = (*iter)->stamp;
+            last = (*iter)->stamp;
         }
-        float recFPS = static_cast<float>(duration + last - first) / (getDoneCount(true) + getDoneCount(false));
-        return (recFPS < (1.f / MAX_VIDEO_FPS))? MAX_VIDEO_FPS:((recFPS > (1.f / MIN_VIDEO_FPS))?
+        duration += last - first; // In milliseconds
+
+        short intervals = 0; // Between two frames
+        if (getDoneCount(true))
+            intervals += getDoneCount(true) - 1;
+        if (getDoneCount(false))
+            intervals += getDoneCount(false) - 1;
+        if ((!intervals) || (!duration))
+            return mRate;
+
+        float recFPS = (duration / 1000.f) / intervals; // Seconds per frame
+        return (recFPS < (1.f / mRate))? mRate:((recFPS > (1.f / MIN_VIDEO_FPS))?
                 MIN_VIDEO_FPS:static_cast<unsigned char>(1.f / recFPS));
     };
 
@@ -99,27 +164,79 @@ private:
     bool mLandscape;
     const std::string* mFolder; // Picture folder
 
+    FrameQueue<RecFrame*> mQueue; // Frames to convert (from capture thread to conversion threads)
+    unsigned int mQueueFull; // Frame count not queued (queue full)
+    unsigned int mRingMiss; // Frame count without ring slot (spilled or dropped)
+    unsigned int mSequence; // Camera frame sequence number of the last added frame (see 'CamFrame::published')
+
+    // Scheduler (conversion threads side)
+    RecFrame* mPending[RECORD_FRAMES_BEFORE + RECORD_FRAMES_AFTER]; // Frames dequeued but not converted yet
+    short mPendingCount;
+    unsigned int mGO; // GO capture time (newest B4 frame)
+    unsigned int mConvTime; // Average conversion duration (in milliseconds)
+
+    volatile unsigned int mDeadline; // Conversion expected to be finished at (0: Unknown - see 'setProgress')
+    volatile bool mRecording; // After GO frames are still captured (see 'stop')
+    unsigned char mWorkers;
+    static unsigned char getWorkers(); // Conversion thread count according the core count
+
+    RecFrame* schedule(unsigned char worker); // Next frame to convert (NULL if none or worker not allowed)
+
     volatile bool mAbort;
-    boost::mutex mMutex;
-    boost::thread* mThread;
+    boost::mutex mMutex; // Conversion threads only (one consumer at a time)
+    boost::condition_variable mCondition; // Signaled when a frame is queued (or abort)
+    std::vector<boost::thread*> mThreads; // Conversion workers
 
-    void processThreadRunning();
-    static void startProcessThread(Recorder* recorder);
+#ifdef __ANDROID__
+    FrameCodec mCodecs[RECORD_MAX_WORKER]; // Encoder session per conversion thread (see 'prepare')
+#endif
+
+    void processThreadRunning(unsigned char worker);
+    static void startProcessThread(Recorder* recorder, unsigned char worker);
 
 public:
     Recorder(const std::string* folder);
     virtual ~Recorder();
 
+    enum {
+
+        SPILL_NONE = 0, // Drop frame when no more free slot
+        SPILL_FULL, // Save frame into BIN file when no more free slot (RAM is short)
+        SPILL_ALWAYS // Always save frame into BIN file (no slot)
+    };
+    inline void setSpill(unsigned char policy) { mSpill = policy; }
+    inline void setSpool(bool spool) { mSpool = spool; } // Keep all frames into a single memory-mapped file (instead of RAM)
+
+    inline void setCompress(bool compress) { mCompress = compress; } // Compress frames into RAM while recording (call B4 'reserve')
+    inline bool isCompress() const { return mCompress; }
+
+    inline void setContinuous(bool continuous) { mContinuous = continuous; } // Dashcam mode (call B4 recording)
+    inline bool isContinuous() const { return mContinuous; }
+
+#ifndef PAID_VERSION
+    bool arm(unsigned char fps, const unsigned char* logo); // Select capture frame rate (call B4 recording)
+#else
+    bool arm(unsigned char fps); // ...
+#endif
+    // -> Refused (default frame rate kept) if a self-benchmark shows the device cannot sustain it
+    inline unsigned char getRate() const { return mRate; }
+
     //
-    time_t add(const unsigned char* rgba, bool before);
+    void reserve(); // Allocate ring slots B4 recording
+    void prepare(bool landscape); // Open encoder sessions B4 GO (no codec startup cost on first frame)
+    unsigned int add(const unsigned char* rgba, bool before, unsigned int stamp); // 'stamp': Capture time (see 'CamFrame')
 #ifndef PAID_VERSION
-    void start(const unsigned char* logo, bool landscape);
+    void start(const unsigned char* logo, bool landscape); // GO: Start converting (while recording after GO frames)
+    // -> Compressed mode: Called right after 'reserve' (then again at GO)
 #else
-    void start(bool landscape);
+    void start(bool landscape); // ...
 #endif
+    inline void stop() { mRecording = false; mCondition.notify_all(); } // After GO recording finished
+    void setProgress(float download); // Client frames download progress [0;1] (deadline estimation)
     void clear();
 
-    inline bool isConverted() const { // From BIN to JPEG files
+    bool write(); // Write JPEG buffers into JPEG files (compressed mode)
+    inline bool isConverted() const { // From BIN to JPEG files (or buffers)
 
         for (std::vector<RecFrame*>::const_iterator iter = mBefore.begin(); iter != mBefore.end(); ++iter)
             if (!(*iter)->status) // STATUS_PROGRESS
@@ -145,23 +262,6 @@ private:
 
     Recorder* mRecorder;
     unsigned char mFPS;
-    inline void copyFile(std::string* src, std::string* dst, size_t size, short srcIdx, short dstIdx) const {
-
-        src->resize(size);
-        dst->assign(*src);
-        src->append(numToStr<short>(srcIdx));
-        src->append(JPEG_FILE_EXTENSION);
-        dst->append(numToStr<short>(dstIdx));
-        dst->append(JPEG_FILE_EXTENSION);
-
-        std::ifstream copySrc(src->c_str(), std::ios::binary);
-        std::ofstream copyDst(dst->c_str(), std::ios::binary);
-
-        copyDst << copySrc.rdbuf(); // Copy JPEG file
-
-        copySrc.close();
-        copyDst.close();
-    };
 
     typedef struct {
 
@@ -171,19 +271,62 @@ private:
     } Frame;
     std::vector<Frame*> mPictures;
 
-    short mPicIdx; // Video texture index displaying
-    short mPicCount;
+    short mPicIdx; // Video texture index displaying (timeline entry)
+    short mPicCount; // Timeline entry count
     std::string mFileName; // Video file name (prefixed with '/')
 
 #ifdef __ANDROID__
-    bool miOS;
+    bool miOS; // Existing iOS client (MOV rendition needed)
+    bool mAndroid; // Existing Android client (WebM rendition needed first)
+
+public:
+    enum {
+
+        FORMAT_WEBM = 0,
+        FORMAT_MOV,
+
+        FORMAT_COUNT
+    };
+    enum {
+
+        RENDITION_NONE = 0, // Not needed
+        RENDITION_PENDING, // Not available yet (encoding)
+        RENDITION_READY, // Video file loaded into buffer
+        RENDITION_FAILED
+    };
+
+private:
+    typedef struct {
 
-    char* mBufferWEBM;
-    char* mBufferMOV;
+        volatile unsigned char state;
+        char* buffer; // From buffer pool (only when ready)
+        int size; // In byte
 
-    int mBufferLenWEBM;
-    int mBufferLenMOV;
+    } Rendition;
+    Rendition mRenditions[FORMAT_COUNT]; // Rendition registry per video format (server)
+    boost::mutex mRenditionMutex;
+
+    std::string getPath(unsigned char format) const; // Video file path of a rendition
+    void publish(unsigned char format, bool done); // Load video file & set rendition state (process thread)
+    inline void setRendition(unsigned char format, unsigned char state) { // Without buffer (see 'publish')
+
+        assert(format < FORMAT_COUNT);
+        mRenditionMutex.lock();
+        mRenditions[format].state = state;
+        mRenditionMutex.unlock();
+    };
 #endif
+    FrameTimeline mTimeline; // Source frame & duration of each video frame (see 'save')
+    void timeline(); // Set timeline durations from capture times
+
+    unsigned char mProfile; // Encoder profile selected for the takes (PROFILE_AUTO: Chosen per take)
+    unsigned char mEncProfile; // Encoder profile of the current take (see 'EncoderProfile::choose')
+    void profile(short frames, unsigned char streams = 1); // Set 'mEncProfile' for 'frames' encoded into 'streams'
+
+    unsigned int mAudioSkip; // Audio recorded B4 the first video frame (in milliseconds)
+    unsigned int mBulletStart; // Bullet time position in the video (in milliseconds)
+    unsigned int mBulletLength; // Bullet time duration (in milliseconds)
+
     void mergeWAV();
     unsigned char loadOGG(const std::string &file);
 
@@ -194,7 +337,14 @@ private:
     bool mPlaying;
     bool mTexGen;
     char* mTexBuffer;
+    short mPreviewH; // Preview height of the film texture coordinates (see 'CamFrame::getPreviewTexCoords')
     bool generate();
+#ifdef __ANDROID__
+    bool launch(const std::string &pipeline, unsigned char streams = 1);
+    // -> Launch pipeline fed with all JPEG files ('appsrc' named 'frames') encoded into 'streams' videos
+    std::string getEncoder(bool sound, bool webm, bool mov) const; // WebM &| MOV encoding pipeline to launch
+#endif
+    char* load(const std::string &fileName, int &size) const; // Load video file into a buffer pool buffer
 
     bool mLandscape;
     unsigned char mClientCount; // Bullet time frame count
@@ -265,6 +415,12 @@ public:
     inline const char* getBuffer() const { return mBuffer; }
     inline int getSize() const { return mBufferLen; }
     inline unsigned char getFPS() const { return mFPS; }
+    inline void setProfile(unsigned char profile) { // EncoderProfile::PROFILE_* (for next take - see ENCODER_PROFILE)
+
+        assert((profile < EncoderProfile::PROFILE_COUNT) || (profile == EncoderProfile::PROFILE_AUTO));
+        mProfile = profile;
+    };
+    inline unsigned char getProfile() const { return mEncProfile; }
 
     inline const std::string* getFileName() const { return &mFileName; }
     inline Recorder* getRecorder() { return mRecorder; }
@@ -286,7 +442,8 @@ public:
     inline bool isFilled() const { return (mRcvLen == mBufferLen); }
 #ifdef __ANDROID__
     bool store(bool landscape, bool android); // Server OS
-    void select(bool android); // WebM/MOV buffer & size selection (client OS)
+    bool select(bool android); // WebM/MOV buffer & size selection (client OS): False if not ready yet
+    inline unsigned char getRendition(unsigned char format) const { return mRenditions[format].state; }
 #else
     bool store(bool landscape);
 #endif
@@ -305,7 +462,7 @@ public:
 
     bool save(const FrameList* clients, bool landscape);
     void extract();
-    bool open();
+    bool open(); // Android: WebM rendition ready (see 'publish'); iOS: Load MOV file
 
 };
 
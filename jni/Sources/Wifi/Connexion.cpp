@@ -27,6 +27,7 @@
 
 // Commands
 #define CMD_VERIFY                  "VERIF_MCAM#"
+#define CMD_VERIFY_SESSION          "VERIF_SESSION_MCAM#" // Verify with session resolution (HD session only)
 #define CMD_KEEPALIVE               "KEEPALIVE_MCAM#"
 //#define CMD_SYNCHRO               Send 'time_t' & Reply received 'time_t' to check delay
 #define CMD_GO                      "1"
@@ -35,12 +36,14 @@
 #define CMD_UPLOAD                  "UPLOAD_MCAM#"
 
 #define VERIFY_LEN                  ((sizeof(CMD_VERIFY) - 1) + 3 + SECURITY_LEN + CHECKSUM_LEN) // + 3 -> Frame rank + Orientation + Server OS
+#define VERIFY_SESSION_LEN          ((sizeof(CMD_VERIFY_SESSION) - 1) + 4 + SECURITY_LEN + CHECKSUM_LEN) // + 4 -> ...above + Resolution
+// -> Distinct length from any other request (see 'receive'): Refused by a client with a previous version (no VGA session)
 #define VERIFY_REPLY_LEN            ((sizeof(MCAM_VERSION) - 1) + VERIFY_LEN - 1) // + 3 (above) - 1 -> + 2 -> Main status + Client OS
 #define KEEPALIVE_LEN               ((sizeof(CMD_KEEPALIVE) - 1) + SECURITY_LEN + CHECKSUM_LEN)
 #define ORIENTATION_REPLY_LEN       (ORIENTATION_LEN - 1)
 #define GO_REPLY_LEN                ((sizeof(CMD_REPLY_GO) - 1) + SECURITY_LEN + CHECKSUM_LEN)
 #define GET_LEN                     ((sizeof(CMD_GET) - 1) + SECURITY_LEN + CHECKSUM_LEN)
-#define GET_REPLY_LEN               (GET_LEN + 3) // + 3 -> DIGIT_COUNT(CAM_WIDTH * CAM_HEIGHT * 4) > Picture size (JPEG)
+#define GET_REPLY_LEN               (GET_LEN + 3) // + 3 -> DIGIT_COUNT(CAM_HD_WIDTH * CAM_HD_HEIGHT * 4) > Picture size (JPEG)
 #define DOWNLOAD_LEN                ((sizeof(CMD_DOWNLOAD) - 1) + 1 + SECURITY_LEN + CHECKSUM_LEN) // + 1 -> '1' from begin / '0' next part
 #define UPLOAD_LEN                  ((sizeof(CMD_UPLOAD) - 1) + 5 + SECURITY_LEN + CHECKSUM_LEN) // + 5 -> Video file size (4) + FPS (1)
 #define UPLOAD_REPLY_LEN            ((sizeof(CMD_UPLOAD) - 1) + 2 + SECURITY_LEN + CHECKSUM_LEN) // + 2 -> Packet requested by the client [0;n]
@@ -49,6 +52,8 @@
 #define VERIFY_FRAMENO_IDX          (sizeof(CMD_VERIFY) - 1)
 #define VERIFY_ORIENTATION_IDX      (VERIFY_FRAMENO_IDX + 1)
 #define VERIFY_OS_IDX               (VERIFY_ORIENTATION_IDX + 1)
+#define VERIFY_RESOLUTION_IDX       (VERIFY_OS_IDX + 1) // ...with CMD_VERIFY_SESSION (see VERIFY_SESSION_SHIFT)
+#define VERIFY_SESSION_SHIFT        (sizeof(CMD_VERIFY_SESSION) - sizeof(CMD_VERIFY)) // Index shift with CMD_VERIFY_SESSION
 #define ORIENTATION_IDX             (sizeof(CMD_ORIENTATION) - 1)
 #define DOWNLOAD_FROM_IDX           (sizeof(CMD_DOWNLOAD) - 1)
 #define UPLOAD_SIZE_IDX             (sizeof(CMD_UPLOAD) - 1)
@@ -66,6 +71,9 @@ Connexion::Connexion(bool server, Level* caller, bool connected) : mServer(serve
 
     LOGV(LOG_LEVEL_CONNEXION, 0, LOG_FORMAT(" - s:%s"), __PRETTY_FUNCTION__, __LINE__, (server)? "true":"false");
     mSocket = new Socket(server);
+#ifdef __ANDROID__
+    mMovWaiting = false;
+#endif
 }
 Connexion::~Connexion() {
 
@@ -80,6 +88,7 @@ Connexion::~Connexion() {
     for (ClientList::iterator iter = mClients.begin(); iter != mClients.end(); ++iter)
         delete (*iter);
     mClients.clear();
+    CamFrame::resetSession(); // Disconnected: Server resolution no more applied
 #ifdef __ANDROID__
     for (Video::FrameList::iterator iter = mFrames.begin(); iter != mFrames.end(); ++iter)
         delete (*iter);
@@ -328,6 +337,41 @@ bool Connexion::replyUpload(short packet) {
 
     return send(reply, UPLOAD_REPLY_LEN);
 }
+#ifdef __ANDROID__
+void Connexion::upload(bool android) {
+
+    LOGV(LOG_LEVEL_CONNEXION, 0, LOG_FORMAT(" - a:%s"), __PRETTY_FUNCTION__, __LINE__, (android)? "true":"false");
+    assert(mServer);
+
+    char upload[UPLOAD_LEN + 1] = {0};
+    std::memcpy(upload, CMD_UPLOAD, sizeof(CMD_UPLOAD));
+    for (unsigned char i = 0; i < static_cast<unsigned char>(mClients.size()); ++i) {
+        if ((mClients[i]->getStatus() != ClientMgr::RCV_REPLY_NONE) || (mClients[i]->isAndroid() != android))
+            continue;
+
+        if ((!mVideo->select(android)) && (mVideo->getRendition((android)? Video::FORMAT_WEBM:Video::FORMAT_MOV) ==
+                Video::RENDITION_PENDING)) {
+
+            LOGI(LOG_LEVEL_CONNEXION, 0, LOG_FORMAT(" - Video not ready yet for client %d"), __PRETTY_FUNCTION__,
+                    __LINE__, i);
+            continue; // Keep alive (see 'CONN_UPLOAD')
+        }
+
+        // Set video size according client OS:
+        // * Android -> WebM file size
+        // * iOS -> MOV file size
+        // -> 0 if failed to create the video file: no upload reply (see client side)
+        upload[UPLOAD_SIZE_IDX] = static_cast<char>(mVideo->getSize() >> 24);
+        upload[UPLOAD_SIZE_IDX + 1] = static_cast<char>(mVideo->getSize() >> 16);
+        upload[UPLOAD_SIZE_IDX + 2] = static_cast<char>(mVideo->getSize() >> 8);
+        upload[UPLOAD_SIZE_IDX + 3] = static_cast<char>(mVideo->getSize());
+
+        upload[UPLOAD_FPS_IDX] = static_cast<char>(mVideo->getFPS()); // Add FPS
+
+        send(upload, UPLOAD_LEN, i, ClientMgr::RCV_REPLY_UPLOAD);
+    }
+}
+#endif
 bool Connexion::send(const char* data, size_t len, unsigned char client, unsigned char reply) {
 
 #ifdef DEBUG
@@ -388,8 +432,14 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
             }
             switch (mClients[i]->getStatus()) {
                 case ClientMgr::RCV_REPLY_NONE: {
+#ifdef __ANDROID__
+                    if ((mStatus == CONN_DOWNLOAD) || ((mStatus == CONN_UPLOAD) &&
+                            ((!mMovWaiting) || (mClients[i]->isAndroid()))))
+                        break; // No keep alive for those status (except iOS clients waiting the MOV rendition)
+#else
                     if ((mStatus == CONN_DOWNLOAD) || (mStatus == CONN_UPLOAD))
                         break; // No keep alive for those status
+#endif
 
                     if (difftime(now, mClients[i]->getTimeOut()) > KEEPALIVE_INTERVAL) {
 
@@ -479,6 +529,11 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
 
                     // Check if ready to download frame picture (check picture size)
                     mPicSize = extractPicSize(i);
+                    if (mPicSize > static_cast<unsigned int>(CamFrame::getSize(4))) { // JPEG > Session frame buffer
+
+                        LOGW(LOG_FORMAT(" - Wrong client %d picture size: %u"), __PRETTY_FUNCTION__, __LINE__, i, mPicSize);
+                        mPicSize = 0;
+                    }
                     if (!mPicSize) {
                         send(CMD_GET, GET_LEN, i, ClientMgr::RCV_REPLY_GET); // Send CMD_GET again
                         break;
@@ -548,7 +603,7 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
 #ifdef __ANDROID__
                     mVideo->select(mClients[i]->isAndroid());
 #endif
-                    assert(mVideo->getBuffer()); // Always true even for iOS clients (see 'mVideo->open()' call below)
+                    assert(mVideo->getBuffer()); // Always true even for iOS clients (see 'upload' calls below)
                                                  // -> Coz no upload reply if no MOV file (see client side)
                     if (!isExpectedReply(UPLOAD_REPLY_LEN, CMD_UPLOAD, sizeof(CMD_UPLOAD) - 1, i)) break;
                     mClients[i]->reset();
@@ -590,6 +645,20 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
 
             case CONN_DOWNLOAD: {
 
+                // Give client frames download progress to the recorder (conversion deadline)
+                float progress = 0.f;
+                unsigned char count = 0;
+                for (unsigned char i = 0; i < static_cast<unsigned char>(mClients.size()); ++i) {
+                    if (mClients[i]->getStatus() == ClientMgr::RCV_REPLY_ERROR)
+                        continue;
+
+                    ++count;
+                    if (mVideo->get(i))
+                        progress += mVideo->get(i)->getProgress();
+                }
+                if (count)
+                    mVideo->getRecorder()->setProgress(progress / count);
+
                 // Check no more client available after Go! pressed - Time out/Error management after CONN_GO here!
                 if (isAllStatus(ClientMgr::RCV_REPLY_ERROR)) {
 
@@ -649,29 +718,16 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
                         // Open video file to be uploaded to clients (WebM &| MOV)
                         if (mVideo->open()) {
 
-                            char upload[UPLOAD_LEN + 1] = {0};
-                            std::memcpy(upload, CMD_UPLOAD, sizeof(CMD_UPLOAD));
 #ifdef __ANDROID__
-                            // Send CMD_UPLOAD only to clients at RCV_REPLY_NONE status
-                            for (unsigned char i = 0; i < static_cast<unsigned char>(mClients.size()); ++i) {
-                                if (mClients[i]->getStatus() != ClientMgr::RCV_REPLY_NONE)
-                                    continue;
-
-                                mVideo->select(mClients[i]->isAndroid());
-
-                                // Set video size according client OS:
-                                // * Android -> WebM file size
-                                // * iOS -> MOV file size
-                                upload[UPLOAD_SIZE_IDX] = static_cast<char>(mVideo->getSize() >> 24);
-                                upload[UPLOAD_SIZE_IDX + 1] = static_cast<char>(mVideo->getSize() >> 16);
-                                upload[UPLOAD_SIZE_IDX + 2] = static_cast<char>(mVideo->getSize() >> 8);
-                                upload[UPLOAD_SIZE_IDX + 3] = static_cast<char>(mVideo->getSize());
-
-                                upload[UPLOAD_FPS_IDX] = static_cast<char>(mVideo->getFPS()); // Add FPS
-
-                                send(upload, UPLOAD_LEN, i, ClientMgr::RCV_REPLY_UPLOAD);
-                            }
+                            // Send CMD_UPLOAD only to clients at RCV_REPLY_NONE status: Android clients now & iOS
+                            // clients when the MOV rendition is available (if not yet - see CONN_UPLOAD below)
+                            upload(true);
+                            mMovWaiting = (mVideo->getRendition(Video::FORMAT_MOV) == Video::RENDITION_PENDING);
+                            if (!mMovWaiting)
+                                upload(false);
 #else
+                            char upload[UPLOAD_LEN + 1] = {0};
+                            std::memcpy(upload, CMD_UPLOAD, sizeof(CMD_UPLOAD));
                             // Add video size (MOV file size)
                             upload[UPLOAD_SIZE_IDX] = static_cast<char>(mVideo->getSize() >> 24);
                             upload[UPLOAD_SIZE_IDX + 1] = static_cast<char>(mVideo->getSize() >> 16);
@@ -693,8 +749,21 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
             }
             case CONN_UPLOAD: {
 
+#ifdef __ANDROID__
+                // MOV rendition created (or failed): Upload it to iOS clients (not in Keepalive processus)
+                if ((mMovWaiting) && (mVideo->getRendition(Video::FORMAT_MOV) != Video::RENDITION_PENDING) &&
+                        (!isAnyStatus(ClientMgr::RCV_REPLY_KEEPALIVE))) {
+
+                    upload(false);
+                    mMovWaiting = false;
+                }
+#endif
                 // From here ClientMgr::RCV_REPLY_NONE client means upload video done! / Failed to open video!
+#ifdef __ANDROID__
+                if ((!mMovWaiting) && (isAllStatus(ClientMgr::RCV_REPLY_NONE, ClientMgr::RCV_REPLY_ERROR))) {
+#else
                 if (isAllStatus(ClientMgr::RCV_REPLY_NONE, ClientMgr::RCV_REPLY_ERROR)) {
+#endif
 
                     if (mVideo->getStatus()) { // Processus terminated (all JPEG picture are in RGBA buffers...
 
@@ -754,6 +823,11 @@ unsigned char Connexion::receive(time_t now, time_t timeout) {
                             (!verifyCheckSum(mCurClient))) break;
                     return ClientMgr::RCV_REPLY_VERIFY;
                 }
+                case VERIFY_SESSION_LEN: {
+                    if ((std::memcmp(mCurClient->getRcvBuffer(), CMD_VERIFY_SESSION, sizeof(CMD_VERIFY_SESSION) - 1)) ||
+                            (!verifyCheckSum(mCurClient))) break;
+                    return ClientMgr::RCV_REPLY_VERIFY;
+                }
                 case KEEPALIVE_LEN: {
                     if ((std::memcmp(mCurClient->getRcvBuffer(), CMD_KEEPALIVE, sizeof(CMD_KEEPALIVE) - 1)) ||
                             (!verifyCheckSum(mCurClient))) break;
@@ -828,7 +902,8 @@ void Connexion::connexionThreadRunning() {
                         assert(mSocket->getClientCount() > getClientCount());
 
                         int security = (std::rand() % 65536); // [0;65535]
-                        std::string verify(CMD_VERIFY);
+                        bool hd = (CamFrame::getSession() == CamFrame::RES_HD);
+                        std::string verify((hd)? CMD_VERIFY_SESSION:CMD_VERIFY);
                         verify += static_cast<char>(getClientCount() + 2); // Frame rank
                         verify += (static_cast<const MatrixLevel*>(mCaller)->mLandscape)?
                                 ORIENTATION_LAND:ORIENTATION_PORT; // Orientation
@@ -837,9 +912,11 @@ void Connexion::connexionThreadRunning() {
 #else
                         verify += OS_IOS; // ...
 #endif
-
-                        addCheckSum(verify.c_str(), VERIFY_LEN, security);
-                        if (mSocket->send(mSendBuffer, VERIFY_LEN, getClientCount()) != VERIFY_LEN) {
+                        if (hd)
+                            verify += static_cast<char>('0' + CamFrame::RES_HD); // Resolution
+                        size_t len = (hd)? VERIFY_SESSION_LEN:VERIFY_LEN;
+                        addCheckSum(verify.c_str(), len, security);
+                        if (mSocket->send(mSendBuffer, len, getClientCount()) != len) {
 
                             LOGE(LOG_FORMAT(" - Failed to send verify request (cli:%d)"), __PRETTY_FUNCTION__, __LINE__,
                                     getClientCount());
@@ -894,7 +971,8 @@ void Connexion::connexionThreadRunning() {
                     if (isAllStatus(ClientMgr::RCV_REPLY_NONE)) {
                         for (unsigned char i = 0; i < static_cast<unsigned char>(mClients.size()); ++i) {
 
-                            std::string verify(CMD_VERIFY);
+                            bool hd = (CamFrame::getSession() == CamFrame::RES_HD);
+                            std::string verify((hd)? CMD_VERIFY_SESSION:CMD_VERIFY);
                             verify += static_cast<char>(i + 2); // Frame rank
                             verify += (static_cast<const MatrixLevel*>(mCaller)->mLandscape)?
                                     ORIENTATION_LAND:ORIENTATION_PORT; // Orientation
@@ -903,7 +981,9 @@ void Connexion::connexionThreadRunning() {
 #else
                             verify += OS_IOS; // ...
 #endif
-                            if (!send(verify.c_str(), VERIFY_LEN, i, ClientMgr::RCV_REPLY_VERIFY))
+                            if (hd)
+                                verify += static_cast<char>('0' + CamFrame::RES_HD); // Resolution
+                            if (!send(verify.c_str(), (hd)? VERIFY_SESSION_LEN:VERIFY_LEN, i, ClientMgr::RCV_REPLY_VERIFY))
                                 break;
                         }
                         if (mStatus != CONN_TIMEOUT)
@@ -972,16 +1052,26 @@ void Connexion::connexionThreadRunning() {
                         case ClientMgr::RCV_REPLY_VERIFY: {
 
                             // Assign frame No & orientation
-                            mCurClient->setRank(static_cast<unsigned char>(mCurClient->getRcvBuffer()[VERIFY_FRAMENO_IDX]));
+                            bool session = (mCurClient->getRcvLength() == VERIFY_SESSION_LEN); // CMD_VERIFY_SESSION
+                            const char* verify = mCurClient->getRcvBuffer() + ((session)? VERIFY_SESSION_SHIFT:0);
+                            mCurClient->setRank(static_cast<unsigned char>(verify[VERIFY_FRAMENO_IDX]));
                             static_cast<MatrixLevel*>(mCaller)->mLandscape =
-                                    (mCurClient->getRcvBuffer()[VERIFY_ORIENTATION_IDX] == ORIENTATION_LAND)? true:false;
+                                    (verify[VERIFY_ORIENTATION_IDX] == ORIENTATION_LAND)? true:false;
                             if (static_cast<const MatrixLevel*>(mCaller)->mStatus != MatrixLevel::MCAM_DISPLAY)
                                 static_cast<MatrixLevel*>(mCaller)->mStatus = MatrixLevel::MCAM_FRAMENO;
 #ifdef __ANDROID__
                             LOGI(LOG_LEVEL_CONNEXION, 0, LOG_FORMAT(" - Server OS: %s"), __PRETTY_FUNCTION__, __LINE__,
-                                    (mCurClient->getRcvBuffer()[VERIFY_OS_IDX] == OS_ANDROID)? "Android":"iOS");
-                            mCurClient->setOS(mCurClient->getRcvBuffer()[VERIFY_OS_IDX] == OS_ANDROID); // ... & Server OS
+                                    (verify[VERIFY_OS_IDX] == OS_ANDROID)? "Android":"iOS");
+                            mCurClient->setOS(verify[VERIFY_OS_IDX] == OS_ANDROID); // ... & Server OS
 #endif
+                            // Session resolution: VGA if no resolution (VGA session or server with a previous version)
+                            unsigned char resolution = ((session) &&
+                                    (verify[VERIFY_RESOLUTION_IDX] == ('0' + CamFrame::RES_HD)))?
+                                    CamFrame::RES_HD:CamFrame::RES_VGA;
+                            LOGI(LOG_LEVEL_CONNEXION, 0, LOG_FORMAT(" - Session resolution: %d"), __PRETTY_FUNCTION__,
+                                    __LINE__, resolution);
+                            CamFrame::setSession(resolution);
+                            // -> Client picture scaled to the session resolution (see 'Picture::processThreadRunning')
                             // Reply to verify request
                             std::string reply(CMD_VERIFY);
                             reply.append(MCAM_VERSION); // Application version
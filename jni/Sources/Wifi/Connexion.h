@@ -71,6 +71,10 @@ private:
             mFrames.push_back((*iter)->getStatus() == ClientMgr::RCV_REPLY_NONE);
 #endif
     };
+#ifdef __ANDROID__
+    bool mMovWaiting; // iOS clients waiting for the MOV rendition (encoded after the WebM - see 'Video::extract')
+    void upload(bool android); // Send CMD_UPLOAD to clients at RCV_REPLY_NONE status with 'android' OS (server)
+#endif
     ClientList mClients;
     ClientMgr* mCurClient;
     bool mCloseAll;
@@ -142,6 +146,9 @@ private:
 
         mTimeOutIdx = 0;
         mStatus = CONN_WAIT; // Back to initial step (wait client)
+#ifdef __ANDROID__
+        mMovWaiting = false;
+#endif
         for (unsigned char i = 0; i < static_cast<unsigned char>(mClients.size()); ++i)
             if (mClients[i]->getStatus() == ClientMgr::RCV_REPLY_ERROR) {
 
@@ -0,0 +1,89 @@
+#include "Video/FramePath.h"
+
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#define JPEG_FILE_EXTENSION         ".jpg" // See 'Picture.h'
+#define BIN_FILE_EXTENSION          ".bin"
+
+#define TEST_TAKE_FRAMES            150 // Frames of a take (recorded & bullet time)
+#define TEST_FOLDER                 "/storage/emulated/0/Android/data/com.studio.artaban.bullettime/files"
+
+////// Allocation counter (any 'new' of the process)
+static unsigned int gNewCount = 0;
+
+void* operator new(std::size_t size) throw(std::bad_alloc) {
+
+    ++gNewCount;
+    void* ptr = std::malloc((size)? size:1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](std::size_t size) throw(std::bad_alloc) { return operator new(size); }
+void operator delete(void* ptr) throw() { std::free(ptr); }
+void operator delete[](void* ptr) throw() { std::free(ptr); }
+
+////// Frame paths built B4 'FramePath' (reference)
+template<typename T>
+static std::string numToStr(T number) { // libeng 'numToStr' (not available on the host)
+
+    std::ostringstream oss;
+    oss << number;
+    return oss.str();
+}
+static size_t stringPath(const std::string* folder, short index, const char* extension) {
+
+    std::string fileName(*folder);
+    fileName.append(MCAM_SUB_FOLDER);
+    fileName.append(PIC_FILE_NAME);
+    fileName.append(numToStr<short>(index));
+    fileName.append(extension);
+    return fileName.size();
+}
+
+//////
+int main() {
+
+    // Paths of each frame during a take: Recorded JPEG written, JPEG read by the encoder ('Video::launch'), BIN
+    // written by 'Picture::extract' & read by 'Video::generate' (display)
+    const std::string folder(TEST_FOLDER);
+    size_t length = 0;
+
+    unsigned int begin = gNewCount;
+    for (short frame = 0; frame < TEST_TAKE_FRAMES; ++frame) {
+
+        length += stringPath(&folder, frame, JPEG_FILE_EXTENSION);
+        length += stringPath(&folder, frame, JPEG_FILE_EXTENSION);
+        length += stringPath(&folder, frame, BIN_FILE_EXTENSION);
+        length += stringPath(&folder, frame, BIN_FILE_EXTENSION);
+    }
+    unsigned int before = gNewCount - begin;
+
+    begin = gNewCount;
+    for (short frame = 0; frame < TEST_TAKE_FRAMES; ++frame) {
+
+        FramePath path(&folder); // Per frame (worst case: one 'FramePath' per function)
+        length -= std::strlen(path.get(frame, JPEG_FILE_EXTENSION));
+        length -= std::strlen(path.get(frame, JPEG_FILE_EXTENSION));
+        length -= std::strlen(path.get(frame, BIN_FILE_EXTENSION));
+        length -= std::strlen(path.get(frame, BIN_FILE_EXTENSION));
+    }
+    unsigned int after = gNewCount - begin;
+
+    printf("Allocations for a %d frames take: %u with 'std::string' paths (%.1f per frame), %u with 'FramePath' "
+            "(%.1f per frame)\n", TEST_TAKE_FRAMES, before, before / static_cast<float>(TEST_TAKE_FRAMES), after,
+            after / static_cast<float>(TEST_TAKE_FRAMES));
+    if (length) {
+
+        fprintf(stderr, "Different path lengths\n");
+        return EXIT_FAILURE;
+    }
+    if (after) {
+
+        fprintf(stderr, "%u allocation(s) with 'FramePath'\n", after);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
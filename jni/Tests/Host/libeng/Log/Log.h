@@ -0,0 +1,16 @@
+#ifndef LIBENG_LOG_H_
+#define LIBENG_LOG_H_
+
+// Host build of the tests: libeng logs (Android/iOS only) reduced to error messages
+
+#include <assert.h>
+#include <stdio.h>
+
+#define LOG_FORMAT(f)               "%s[%d]" f "\n"
+
+#define LOGV(level, cond, ...)      ((void)0)
+#define LOGI(level, cond, ...)      ((void)0)
+#define LOGW(...)                   ((void)0)
+#define LOGE(...)                   fprintf(stderr, __VA_ARGS__)
+
+#endif // LIBENG_LOG_H_
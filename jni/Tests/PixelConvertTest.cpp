@@ -0,0 +1,176 @@
+#include "Video/PixelConvert.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#define TEST_GUARD                  32 // Bytes checked after the converted ones (no overrun)
+#define TEST_GUARD_VALUE            0xa5
+#define TEST_MAX_COUNT              1280 // Pixels (HD row)
+
+static const int gCounts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 100, 127,
+        129, 640, 1279, TEST_MAX_COUNT }; // Edge widths (vector widths +/- 1 & odd tails)
+static int gFailures = 0;
+
+////// Loops replaced by 'PixelConvert' (references)
+static void swizzleRef(unsigned char* rgba, const unsigned char* data, int count) { // 'Picture::record' (BGRA -> RGBA)
+
+    for (int x = 0, pix = 0; x < count; ++x, pix += 4) {
+
+        rgba[pix] = data[pix + 2];
+        rgba[pix + 1] = data[pix + 1];
+        rgba[pix + 2] = data[pix];
+        rgba[pix + 3] = data[pix + 3];
+    }
+}
+static void toRGBRef(unsigned char* out, const unsigned char* in, int count, bool bgra) { // 'PixelKernel::record'
+
+    for (int x = 0; x < count; ++x, out += 3) {
+
+        const unsigned char* pix = in + (x * 4);
+        out[0] = pix[(bgra)? 2:0];
+        out[1] = pix[1];
+        out[2] = pix[(bgra)? 0:2];
+    }
+}
+static void toLARef(unsigned char* grayBuffer, const unsigned char* buffer, int count) { // 'loadTexture' (JNI.cpp)
+
+    for (int i = 0; i < count; ++i) {
+
+        grayBuffer[(i * 2) + 0] = buffer[(i * 4) + 0]; // Luminance (Red == Green == Blue: 0 -> Red)
+        grayBuffer[(i * 2) + 1] = buffer[(i * 4) + 3]; // Alpha
+    }
+}
+static void blendRef(unsigned char* dst, const unsigned char* premul, const unsigned char* inverse, int count) {
+
+    for (int i = 0; i < count; ++i) // Rounded division by 255 (see 'PixelConvert::blend')
+        dst[i] = static_cast<unsigned char>(premul[i] + (((dst[i] * inverse[i]) + 127) / 255));
+}
+static void padRef(unsigned char* tex, const unsigned char* rgb, short width, short height, short texWidth) {
+
+    int xLag = 0; // 'Picture::extract'
+    for (short y = 0; y < height; ++y) {
+        for (short x = 0; x < width; ++x) {
+
+            int i = ((y * width) + x) * 3;
+            tex[i + xLag + 0] = rgb[i + 0];
+            tex[i + xLag + 1] = rgb[i + 1];
+            tex[i + xLag + 2] = rgb[i + 2];
+        }
+        xLag += (texWidth - width) * 3;
+    }
+}
+
+//////
+static void fill(std::vector<unsigned char> &buffer, unsigned int seed) {
+
+    for (size_t i = 0; i < buffer.size(); ++i) {
+
+        seed = (seed * 1103515245u) + 12345u; // Any byte value (including 0 & 255)
+        buffer[i] = static_cast<unsigned char>(seed >> 16);
+    }
+}
+static void check(const char* name, int count, unsigned char offset, const std::vector<unsigned char> &expected,
+        const std::vector<unsigned char> &result, size_t size) {
+
+    if (std::memcmp(&expected[0], &result[offset], size)) {
+
+        fprintf(stderr, "%s: %d pixel(s) (offset %d) differ from the reference loop\n", name, count, offset);
+        ++gFailures;
+    }
+    for (size_t i = offset + size; i < (offset + size + TEST_GUARD); ++i) {
+        if (result[i] != TEST_GUARD_VALUE) {
+
+            fprintf(stderr, "%s: %d pixel(s) (offset %d) written after the last pixel\n", name, count, offset);
+            ++gFailures;
+            break;
+        }
+    }
+}
+
+int main() {
+
+    printf("Conversion path: %d (0: Scalar; 1: SSE2; 2: NEON)\n", PixelConvert::getPath());
+    std::vector<unsigned char> src((TEST_MAX_COUNT * 4) + 16);
+    std::vector<unsigned char> premul((TEST_MAX_COUNT * 4) + 16);
+    std::vector<unsigned char> inverse((TEST_MAX_COUNT * 4) + 16);
+    std::vector<unsigned char> expected((TEST_MAX_COUNT * 4) + 16);
+    std::vector<unsigned char> result((TEST_MAX_COUNT * 4) + 16 + TEST_GUARD);
+
+    for (size_t c = 0; c < (sizeof(gCounts) / sizeof(int)); ++c) {
+        for (unsigned char offset = 0; offset < 2; ++offset) { // Aligned & unaligned buffers
+
+            int count = gCounts[c];
+            fill(src, static_cast<unsigned int>(count + 1));
+            const unsigned char* in = &src[offset];
+
+            // Swizzle (separate & in place)
+            swizzleRef(&expected[0], in, count);
+            std::memset(&result[0], TEST_GUARD_VALUE, result.size());
+            PixelConvert::swizzle(reinterpret_cast<char*>(&result[offset]), reinterpret_cast<const char*>(in), count);
+            check("swizzle", count, offset, expected, result, count * 4);
+
+            std::memset(&result[0], TEST_GUARD_VALUE, result.size());
+            std::memcpy(&result[offset], in, count * 4);
+            PixelConvert::swizzle(reinterpret_cast<char*>(&result[offset]), reinterpret_cast<const char*>(&result[offset]),
+                    count);
+            check("swizzle (in place)", count, offset, expected, result, count * 4);
+
+            // RGB from RGBA & BGRA
+            for (unsigned char bgra = 0; bgra < 2; ++bgra) {
+
+                toRGBRef(&expected[0], in, count, bgra != 0);
+                std::memset(&result[0], TEST_GUARD_VALUE, result.size());
+                PixelConvert::toRGB(reinterpret_cast<char*>(&result[offset]), reinterpret_cast<const char*>(in), count,
+                        bgra != 0);
+                check((bgra)? "toRGB (BGRA)":"toRGB (RGBA)", count, offset, expected, result, count * 3);
+            }
+
+            // LA
+            toLARef(&expected[0], in, count);
+            std::memset(&result[0], TEST_GUARD_VALUE, result.size());
+            PixelConvert::toLA(reinterpret_cast<char*>(&result[offset]), reinterpret_cast<const char*>(in), count);
+            check("toLA", count, offset, expected, result, count * 2);
+
+            // Blend (premultiplied overlay: 'premul' <= 255 - 'inverse')
+            fill(inverse, static_cast<unsigned int>(count + 7));
+            fill(premul, static_cast<unsigned int>(count + 13));
+            for (int i = 0; i < (count * 3); ++i)
+                premul[i] = static_cast<unsigned char>(premul[i] % (256 - inverse[i]));
+            std::memcpy(&expected[0], in, count * 3);
+            blendRef(&expected[0], &premul[0], &inverse[0], count * 3);
+            std::memset(&result[0], TEST_GUARD_VALUE, result.size());
+            std::memcpy(&result[offset], in, count * 3);
+            PixelConvert::blend(reinterpret_cast<char*>(&result[offset]), &premul[0], &inverse[0], count * 3);
+            check("blend", count, offset, expected, result, count * 3);
+        }
+    }
+
+    // Texture padding ('Picture::extract' resolutions & odd widths)
+    static const short sizes[][3] = { { 640, 480, 1024 }, { 640, 360, 1024 }, { 1280, 720, 2048 }, { 17, 5, 32 },
+            { 1, 3, 1 }, { 0, 0, 16 } };
+    for (size_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s) {
+
+        short width = sizes[s][0], height = sizes[s][1], texWidth = sizes[s][2];
+        std::vector<unsigned char> rgb((width * height * 3) + 1);
+        fill(rgb, static_cast<unsigned int>(s));
+        std::vector<unsigned char> padExpected((texWidth * height * 3) + 1, TEST_GUARD_VALUE);
+        std::vector<unsigned char> padResult((texWidth * height * 3) + 1, TEST_GUARD_VALUE);
+        padRef(&padExpected[0], &rgb[0], width, height, texWidth);
+        PixelConvert::pad(reinterpret_cast<char*>(&padResult[0]), reinterpret_cast<const char*>(&rgb[0]), width, height,
+                texWidth);
+        if (padExpected != padResult) {
+
+            fprintf(stderr, "pad: %dx%d (%d texels) differs from the reference loop\n", width, height, texWidth);
+            ++gFailures;
+        }
+    }
+
+    if (gFailures) {
+
+        fprintf(stderr, "%d failure(s)\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("All conversions bit-exact\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#include "Video/PixelKernel.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+static int gFailures = 0;
+
+////// 'Picture::orientation' loop replaced by 'PixelKernel::rotate' (reference)
+static void rotateRef(unsigned char* buffer, const unsigned char* land, short width, short height, bool land2port) {
+
+    for (short xPort = 0, xLand = 0; xPort < width; ++xPort, ++xLand) {
+        for (short yPort = 0, yLand = (height - 1); yPort < height; ++yPort, --yLand) {
+
+            int iPort = ((xPort * height) + yPort) * 3;
+            int iLand = ((yLand * width) + xLand) * 3;
+
+            if (!land2port) // From portrait to landscape
+                std::swap<int>(iPort, iLand);
+            //else // From landscape to portrait
+
+            buffer[iPort + 0] = land[iLand + 0];
+            buffer[iPort + 1] = land[iLand + 1];
+            buffer[iPort + 2] = land[iLand + 2];
+        }
+    }
+}
+
+//////
+int main() {
+
+    static const short sizes[][2] = { { 640, 480 }, { 1280, 720 }, { 640, 360 }, { 17, 5 }, { 33, 18 }, { 16, 16 },
+            { 1, 1 } }; // Specialized resolutions & partial tiles (any resolution)
+    for (size_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s) {
+        for (unsigned char land2port = 0; land2port < 2; ++land2port) {
+
+            short width = sizes[s][0], height = sizes[s][1];
+            size_t size = static_cast<size_t>(width * height * 3);
+            std::vector<unsigned char> src(size);
+            unsigned int seed = static_cast<unsigned int>(s + 1);
+            for (size_t i = 0; i < size; ++i) {
+
+                seed = (seed * 1103515245u) + 12345u;
+                src[i] = static_cast<unsigned char>(seed >> 16);
+            }
+            std::vector<unsigned char> expected(size, 0);
+            std::vector<unsigned char> result(size, 0);
+            rotateRef(&expected[0], &src[0], width, height, land2port != 0);
+            PixelKernel::rotate(reinterpret_cast<char*>(&result[0]), reinterpret_cast<const char*>(&src[0]), width,
+                    height, land2port != 0);
+            if (std::memcmp(&expected[0], &result[0], size)) {
+
+                fprintf(stderr, "rotate: %dx%d (%s) differs from the reference loop\n", width, height,
+                        (land2port)? "land2port":"port2land");
+                ++gFailures;
+            }
+        }
+    }
+
+    if (gFailures) {
+
+        fprintf(stderr, "%d failure(s)\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("All rotations bit-exact\n");
+    return EXIT_SUCCESS;
+}